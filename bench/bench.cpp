@@ -0,0 +1,636 @@
+#include "basicrenderer.h"
+#include "geometrybuffer.h"
+#include "pixelconvert.h"
+#include "polylinereducer.h"
+#include "rasterizer.h"
+#include "renderer.h"
+#include "spritebatch.h"
+#include "texture.h"
+#include "error.h"
+
+#include <SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Throughput of the SDL::Renderer primitive paths on SDL's software renderer.
+// Runs headless on an in-memory surface and prints one JSON object (or CSV
+// line) per case and batch size.
+//
+//   SDL2++_bench [--format=json|csv] [--min-time=SECONDS] [--filter=SUBSTRING]
+//                [--size=WIDTHxHEIGHT] [--backend=sdl|tiled] [--verify]
+//                [--verify-convert]
+//
+// --verify draws the same random primitives with SDL and the tiled backend
+// and exits with 1 if any pixel differs. --verify-convert does the same for
+// SDL::PixelConvert against its scalar kernels and SDL_ConvertPixels.
+
+namespace{
+
+    struct Options{
+        std::string format = "json";
+        std::string filter;
+        double minTime = 0.25;
+        int width = 1024;
+        int height = 768;
+        SDL::SoftwareBackend backend = SDL::SoftwareBackend::SDL;
+        bool verify = false;
+        bool verifyConvert = false;
+    };
+
+    struct Result{
+        std::string name;
+        std::size_t batch;
+        uint64_t iterations;
+        double seconds;
+    };
+
+    class Random{
+        public:
+            Random(uint32_t seed):m_state(seed){}
+            uint32_t Next(){
+                m_state = m_state * 1664525u + 1013904223u;
+                return m_state >> 8;
+            }
+            int Next(int range){ return static_cast<int>(Next() % static_cast<uint32_t>(range)); }
+
+        private:
+            uint32_t m_state;
+    };
+
+    double Seconds(uint64_t ticks){
+        return static_cast<double>(ticks) / SDL_GetPerformanceFrequency();
+    }
+
+    // Calls body, which submits `batch` primitives, until minTime has passed.
+    Result Run(const Options& options, const std::string& name, std::size_t batch, const std::function<void()>& present, const std::function<void()>& body){
+        // Warm up caches and the command buffer arena. Presenting also makes
+        // SDL execute its own queued commands, there is no window to update.
+        body();
+        present();
+
+        uint64_t iterations = 0;
+        const auto begin = SDL_GetPerformanceCounter();
+        auto now = begin;
+        do{
+            for(auto i = 0; i < 8; ++i)
+                body();
+            present();
+            iterations += 8;
+            now = SDL_GetPerformanceCounter();
+        }while(Seconds(now - begin) < options.minTime);
+
+        return Result{name, batch, iterations, Seconds(now - begin)};
+    }
+
+    void Print(const Options& options, const Result& result){
+        const auto primitives = static_cast<double>(result.iterations) * result.batch;
+        const auto perSecond = primitives / result.seconds;
+        const auto nsPerPrimitive = result.seconds * 1e9 / primitives;
+        if(options.format == "csv"){
+            std::cout << result.name << ',' << result.batch << ',' << result.iterations << ','
+                      << result.seconds << ',' << perSecond << ',' << nsPerPrimitive << '\n';
+        }else{
+            std::cout << "{\"case\":\"" << result.name << "\",\"batch\":" << result.batch
+                      << ",\"iterations\":" << result.iterations << ",\"seconds\":" << result.seconds
+                      << ",\"primitives_per_second\":" << perSecond << ",\"ns_per_primitive\":" << nsPerPrimitive << "}\n";
+        }
+    }
+
+    typedef std::unique_ptr<SDL_Surface, void(*)(SDL_Surface*)> SurfacePtr;
+
+    SurfacePtr CreateSurface(int width, int height){
+        SurfacePtr surface(SDL_CreateRGBSurface(0, width, height, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000), SDL_FreeSurface);
+        if(!surface)
+            throw SDL::Error();
+        return surface;
+    }
+
+    const char* const verifyPrimitives[] = {"points", "lines", "rects", "fills"};
+
+    // Random primitives of one kind plus the cases the clipping and line
+    // end points get wrong first: lines on and across the viewport edges,
+    // zero-length and closed polylines, and empty or one pixel rects.
+    void DrawVerifyScene(SDL::Renderer& renderer, int primitive, SDL_BlendMode blendMode, bool clipped, int w, int h){
+        Random random(static_cast<uint32_t>(primitive) * 16 + static_cast<uint32_t>(blendMode) * 2 + clipped);
+        auto rect = [&]{
+            return SDL::Rect{random.Next(w + 64) - 32, random.Next(h + 64) - 32, random.Next(96) - 8, random.Next(96) - 8};
+        };
+        auto point = [&]{
+            return SDL::Point{random.Next(w + 64) - 32, random.Next(h + 64) - 32};
+        };
+        auto color = [&]{
+            renderer.SetRenderDrawColor(static_cast<uint8_t>(random.Next(256)), static_cast<uint8_t>(random.Next(256)),
+                                        static_cast<uint8_t>(random.Next(256)), static_cast<uint8_t>(random.Next(256)));
+        };
+
+        renderer.SetRenderDrawColor(40, 80, 120, 255);
+        renderer.RenderClear();
+        // Drawing coordinates cover the viewport.
+        auto vw = w, vh = h;
+        if(clipped){
+            renderer.RenderSetViewport(SDL::Rect{w / 8, h / 8, w * 3 / 4, h * 3 / 4});
+            renderer.RenderSetClipRect(SDL::Rect{w / 16, h / 16, w / 2, h / 2});
+            vw = w * 3 / 4;
+            vh = h * 3 / 4;
+        }
+        renderer.SetRenderDrawBlendMode(blendMode);
+
+        const std::vector<std::vector<SDL::Point>> edgeLines{
+            {{0, 0}, {vw - 1, 0}, {vw - 1, vh - 1}, {0, vh - 1}, {0, 0}},
+            {{-1, -1}, {vw, -1}, {vw, vh}, {-1, vh}},
+            {{-1000, -500}, {vw + 1000, vh + 700}},
+            {{vw + 300, -200}, {-300, vh + 100}},
+            {{vw / 2, -5000}, {vw / 2 + 3, vh + 5000}},
+            {{-5000, vh / 3}, {vw + 5000, vh / 3 + 1}},
+            {{5, 5}, {5, 5}},
+            {{10, 10}, {40, 20}, {25, 50}, {10, 10}},
+            {{vw - 1, vh / 2}, {vw, vh / 2}, {vw + 1, vh / 2 + 1}}
+        };
+        const std::vector<SDL::Rect> edgeRects{
+            {0, 0, vw, vh}, {-1, -1, vw + 2, vh + 2}, {3, 3, 1, 1}, {7, 7, 0, 5}, {9, 9, -4, 6},
+            {vw - 1, vh - 1, 1, 1}, {-10, vh / 2, 20, 1}, {vw / 2, -10, 1, 20}
+        };
+
+        for(auto i = 0; i < 256; ++i){
+            color();
+            std::vector<SDL::Point> points(1 + random.Next(6));
+            for(auto& p : points)
+                p = point();
+            std::vector<SDL::Rect> rects(1 + random.Next(4));
+            for(auto& r : rects)
+                r = rect();
+            switch(primitive){
+                case 0: renderer.RenderDrawPoints(points); break;
+                case 1: renderer.RenderDrawLines(points); break;
+                case 2: renderer.RenderDrawRects(rects); break;
+                default: renderer.RenderFillRects(rects); break;
+            }
+        }
+        for(auto lines : edgeLines){
+            color();
+            switch(primitive){
+                case 0: renderer.RenderDrawPoints(lines); break;
+                case 1: renderer.RenderDrawLines(lines); break;
+                default: break;
+            }
+        }
+        for(auto edgeRect : edgeRects){
+            color();
+            switch(primitive){
+                case 2: renderer.RenderDrawRect(edgeRect); break;
+                case 3: renderer.RenderFillRect(edgeRect); break;
+                default: break;
+            }
+        }
+        renderer.RenderPresent();
+    }
+
+    // Draws the same scenes with SDL and the tiled backend, per primitive
+    // and blend mode, with and without viewport and clip rect, and counts
+    // differing pixels. Without the command buffer the backend draws on one
+    // thread, with it in tiles. Registered with CTest, so a build against
+    // SDL2 checks that the backend stays pixel-identical.
+    int Verify(const Options& options){
+        const SDL_BlendMode blendModes[] = {SDL_BLENDMODE_NONE, SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD};
+        auto failures = 0;
+        for(auto primitive = 0; primitive < 4; ++primitive){
+            for(auto blendMode : blendModes){
+                for(auto variant = 0; variant < 4; ++variant){
+                    const auto clipped = (variant & 1) != 0;
+                    const auto tiled = (variant & 2) != 0;
+                    auto reference = CreateSurface(options.width, options.height);
+                    auto tested = CreateSurface(options.width, options.height);
+                    auto sdlRenderer = SDL::Renderer::CreateSoftwareRenderer(reference.get(), SDL::SoftwareBackend::SDL);
+                    auto rasterizer = SDL::Renderer::CreateSoftwareRenderer(tested.get(), SDL::SoftwareBackend::Tiled);
+                    rasterizer->EnableCommandBuffer(tiled);
+                    DrawVerifyScene(*sdlRenderer, primitive, blendMode, clipped, options.width, options.height);
+                    DrawVerifyScene(*rasterizer, primitive, blendMode, clipped, options.width, options.height);
+
+                    const auto* expected = static_cast<const uint8_t*>(reference->pixels);
+                    const auto* actual = static_cast<const uint8_t*>(tested->pixels);
+                    auto mismatches = 0, firstX = -1, firstY = -1;
+                    for(auto y = 0; y < options.height; ++y){
+                        const auto* a = reinterpret_cast<const uint32_t*>(expected + y * reference->pitch);
+                        const auto* b = reinterpret_cast<const uint32_t*>(actual + y * tested->pitch);
+                        for(auto x = 0; x < options.width; ++x){
+                            if(a[x] == b[x])
+                                continue;
+                            if(mismatches++ == 0){
+                                firstX = x;
+                                firstY = y;
+                            }
+                        }
+                    }
+                    std::cout << "{\"verify\":\"" << verifyPrimitives[primitive] << "_blend" << static_cast<int>(blendMode) << (clipped ? "_clipped" : "") << (tiled ? "_tiled" : "")
+                              << "\",\"kernel\":\"" << SDL::SurfaceRasterizer::GetKernelName()
+                              << "\",\"mismatches\":" << mismatches << ",\"first\":[" << firstX << "," << firstY << "]}\n";
+                    failures += mismatches != 0;
+                }
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    const uint32_t convertFormats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGRA8888,
+        SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_RGB565
+    };
+    const uint32_t convertYUVFormats[] = {SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YV12, SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21};
+    // Odd widths run into every tail loop, 257 and 301 past one chunk.
+    const int convertWidths[] = {1, 2, 3, 5, 7, 9, 15, 17, 31, 33, 255, 257, 301};
+    // SDL's YUV code rounds its fixed point differently per path.
+    const int yuvTolerance = 2;
+
+    struct ConvertCheck{
+        int scalarMismatches = 0;
+        int sdlMismatches = 0;
+        int firstWidth = -1;
+    };
+
+    std::string FormatName(uint32_t format){
+        // Without the SDL_PIXELFORMAT_ prefix.
+        return SDL_GetPixelFormatName(format) + 16;
+    }
+
+    uint32_t ReadPixel(const uint8_t* p, int bytes){
+        if(bytes == 2){
+            uint16_t pixel;
+            std::memcpy(&pixel, p, 2);
+            return pixel;
+        }
+        if(bytes == 3)
+            return SDL_BYTEORDER == SDL_LIL_ENDIAN ? p[0] | p[1] << 8 | p[2] << 16 : p[0] << 16 | p[1] << 8 | p[2];
+        uint32_t pixel;
+        std::memcpy(&pixel, p, 4);
+        return pixel;
+    }
+
+    // Wider than the row, but 4-byte aligned like SDL's surface pitches.
+    int GetConvertPitch(int w, uint32_t format){
+        return (w * SDL_BYTESPERPIXEL(format) + 3) / 4 * 4 + 4;
+    }
+
+    void Fill(std::vector<uint8_t>& data, Random& random){
+        for(auto& byte : data)
+            byte = static_cast<uint8_t>(random.Next(256));
+    }
+
+    void CountMismatch(ConvertCheck& check, bool scalar, bool sdl, int width){
+        check.scalarMismatches += scalar;
+        check.sdlMismatches += sdl;
+        if((scalar || sdl) && check.firstWidth < 0)
+            check.firstWidth = width;
+    }
+
+    // Packed pixels have to match the scalar kernels byte for byte and SDL
+    // per channel, SDL leaves the padding byte of the X formats alone.
+    void ComparePixels(ConvertCheck& check, uint32_t format, int w, int h, int pitch, const std::vector<uint8_t>& simd,
+                       const std::vector<uint8_t>& scalar, const std::vector<uint8_t>& reference, int tolerance){
+        std::unique_ptr<SDL_PixelFormat, void(*)(SDL_PixelFormat*)> pixelFormat(SDL_AllocFormat(format), SDL_FreeFormat);
+        if(!pixelFormat)
+            throw SDL::Error();
+        const auto bytes = pixelFormat->BytesPerPixel;
+        for(auto y = 0; y < h; ++y){
+            for(auto x = 0; x < w; ++x){
+                const auto offset = y * pitch + x * bytes;
+                uint8_t actual[4], expected[4];
+                SDL_GetRGBA(ReadPixel(simd.data() + offset, bytes), pixelFormat.get(), &actual[0], &actual[1], &actual[2], &actual[3]);
+                SDL_GetRGBA(ReadPixel(reference.data() + offset, bytes), pixelFormat.get(), &expected[0], &expected[1], &expected[2], &expected[3]);
+                auto sdl = false;
+                for(auto c = 0; c < 4; ++c)
+                    sdl = sdl || std::abs(actual[c] - expected[c]) > tolerance;
+                CountMismatch(check, std::memcmp(simd.data() + offset, scalar.data() + offset, bytes) != 0, sdl, w);
+            }
+        }
+    }
+
+    void CompareBytes(ConvertCheck& check, int w, const std::vector<uint8_t>& simd, const std::vector<uint8_t>& scalar,
+                      const std::vector<uint8_t>& reference, int tolerance){
+        for(std::size_t i = 0; i < simd.size(); ++i)
+            CountMismatch(check, simd[i] != scalar[i], std::abs(simd[i] - reference[i]) > tolerance, w);
+    }
+
+    // The back to back planes SDL_ConvertPixels takes, chroma pitch half the
+    // luma pitch rounded up.
+    struct YUVPlanes{
+        uint8_t* y;
+        uint8_t* u;
+        uint8_t* v;
+        int uvPitch;
+    };
+
+    std::size_t GetYUVSize(int w, int h){
+        return static_cast<std::size_t>(w) * h + 2 * static_cast<std::size_t>((w + 1) / 2) * ((h + 1) / 2);
+    }
+
+    YUVPlanes GetYUVPlanes(uint32_t format, std::vector<uint8_t>& data, int w, int h){
+        const auto chromaWidth = (w + 1) / 2;
+        YUVPlanes planes{data.data(), data.data() + w * h, data.data() + w * h + chromaWidth * ((h + 1) / 2), chromaWidth};
+        if(format == SDL_PIXELFORMAT_YV12){
+            std::swap(planes.u, planes.v);
+        }else if(format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21){
+            planes.v = nullptr;
+            planes.uvPitch = chromaWidth * 2;
+        }
+        return planes;
+    }
+
+    // Runs convert(output) with the selected and the scalar kernels.
+    void ConvertBoth(std::vector<uint8_t>& simd, std::vector<uint8_t>& scalar, const std::function<void(std::vector<uint8_t>&)>& convert){
+        SDL::PixelConvert::ForceScalarKernels(false);
+        convert(simd);
+        SDL::PixelConvert::ForceScalarKernels(true);
+        convert(scalar);
+        SDL::PixelConvert::ForceScalarKernels(false);
+    }
+
+    bool ReportConvert(const std::string& name, const ConvertCheck& check){
+        std::cout << "{\"verify\":\"convert_" << name << "\",\"kernel\":\"" << SDL::PixelConvert::GetKernelName()
+                  << "\",\"scalar_mismatches\":" << check.scalarMismatches << ",\"sdl_mismatches\":" << check.sdlMismatches
+                  << ",\"first_width\":" << check.firstWidth << "}\n";
+        return check.scalarMismatches == 0 && check.sdlMismatches == 0;
+    }
+
+    // Converts random pixels between every pair of PixelConvert formats and
+    // between them and each YUV format, with the selected kernels, the
+    // scalar kernels and SDL_ConvertPixels. Registered with CTest next to
+    // the rasterizer check.
+    int VerifyConvert(){
+        Random random(1);
+        auto failures = 0;
+        for(auto srcFormat : convertFormats){
+            for(auto dstFormat : convertFormats){
+                ConvertCheck check;
+                for(auto w : convertWidths){
+                    const auto h = 3;
+                    const auto srcPitch = GetConvertPitch(w, srcFormat);
+                    const auto dstPitch = GetConvertPitch(w, dstFormat);
+                    std::vector<uint8_t> input(srcPitch * h);
+                    Fill(input, random);
+                    std::vector<uint8_t> simd(dstPitch * h), scalar(dstPitch * h), reference(dstPitch * h);
+                    ConvertBoth(simd, scalar, [&](std::vector<uint8_t>& output){
+                        SDL::PixelConvert::Convert(w, h, srcFormat, input.data(), srcPitch, dstFormat, output.data(), dstPitch);
+                    });
+                    if(SDL_ConvertPixels(w, h, srcFormat, input.data(), srcPitch, dstFormat, reference.data(), dstPitch) != 0)
+                        throw SDL::Error();
+                    ComparePixels(check, dstFormat, w, h, dstPitch, simd, scalar, reference, 0);
+                }
+                failures += !ReportConvert(FormatName(srcFormat) + "_" + FormatName(dstFormat), check);
+            }
+        }
+
+        for(auto yuvFormat : convertYUVFormats){
+            for(auto rgbFormat : convertFormats){
+                ConvertCheck toRGB, toYUV;
+                for(auto w : convertWidths){
+                    // An odd height leaves a last row without a chroma pair.
+                    const auto h = 5;
+                    const auto rgbPitch = GetConvertPitch(w, rgbFormat);
+                    std::vector<uint8_t> yuv(GetYUVSize(w, h));
+                    Fill(yuv, random);
+                    std::vector<uint8_t> simd(rgbPitch * h), scalar(rgbPitch * h), reference(rgbPitch * h);
+                    ConvertBoth(simd, scalar, [&](std::vector<uint8_t>& output){
+                        const auto planes = GetYUVPlanes(yuvFormat, yuv, w, h);
+                        SDL::PixelConvert::ConvertYUVToRGB(w, h, yuvFormat, planes.y, w, planes.u, planes.uvPitch, planes.v, planes.uvPitch,
+                                                           rgbFormat, output.data(), rgbPitch);
+                    });
+                    if(SDL_ConvertPixels(w, h, yuvFormat, yuv.data(), w, rgbFormat, reference.data(), rgbPitch) != 0)
+                        throw SDL::Error();
+                    ComparePixels(toRGB, rgbFormat, w, h, rgbPitch, simd, scalar, reference, yuvTolerance);
+
+                    std::vector<uint8_t> rgb(rgbPitch * h);
+                    Fill(rgb, random);
+                    std::vector<uint8_t> simdYUV(yuv.size()), scalarYUV(yuv.size()), referenceYUV(yuv.size());
+                    ConvertBoth(simdYUV, scalarYUV, [&](std::vector<uint8_t>& output){
+                        const auto planes = GetYUVPlanes(yuvFormat, output, w, h);
+                        SDL::PixelConvert::ConvertRGBToYUV(w, h, rgbFormat, rgb.data(), rgbPitch, yuvFormat,
+                                                           planes.y, w, planes.u, planes.uvPitch, planes.v, planes.uvPitch);
+                    });
+                    if(SDL_ConvertPixels(w, h, rgbFormat, rgb.data(), rgbPitch, yuvFormat, referenceYUV.data(), w) != 0)
+                        throw SDL::Error();
+                    CompareBytes(toYUV, w, simdYUV, scalarYUV, referenceYUV, yuvTolerance);
+                }
+                failures += !ReportConvert(FormatName(yuvFormat) + "_" + FormatName(rgbFormat), toRGB);
+                failures += !ReportConvert(FormatName(rgbFormat) + "_" + FormatName(yuvFormat), toYUV);
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options){
+        for(auto i = 1; i < argc; ++i){
+            const std::string arg = argv[i];
+            if(arg.compare(0, 9, "--format=") == 0)
+                options.format = arg.substr(9);
+            else if(arg.compare(0, 11, "--min-time=") == 0)
+                options.minTime = std::atof(arg.c_str() + 11);
+            else if(arg.compare(0, 9, "--filter=") == 0)
+                options.filter = arg.substr(9);
+            else if(arg.compare(0, 7, "--size=") == 0){
+                if(std::sscanf(arg.c_str() + 7, "%dx%d", &options.width, &options.height) != 2)
+                    return false;
+            }else if(arg == "--backend=sdl")
+                options.backend = SDL::SoftwareBackend::SDL;
+            else if(arg == "--backend=tiled")
+                options.backend = SDL::SoftwareBackend::Tiled;
+            else if(arg == "--verify")
+                options.verify = true;
+            else if(arg == "--verify-convert")
+                options.verifyConvert = true;
+            else
+                return false;
+        }
+        return (options.format == "json" || options.format == "csv") && options.minTime > 0.0 && options.width > 0 && options.height > 0;
+    }
+
+}
+
+int main(int argc, char** argv){
+    Options options;
+    if(!ParseOptions(argc, argv, options)){
+        std::cerr << "usage: " << argv[0] << " [--format=json|csv] [--min-time=SECONDS] [--filter=SUBSTRING] [--size=WIDTHxHEIGHT] [--backend=sdl|tiled] [--verify] [--verify-convert]" << std::endl;
+        return 2;
+    }
+
+    try{
+        if(options.verify)
+            return Verify(options);
+        if(options.verifyConvert)
+            return VerifyConvert();
+
+        auto surface = CreateSurface(options.width, options.height);
+        auto renderer = SDL::Renderer::CreateSoftwareRenderer(surface.get(), options.backend);
+        // Same primitives through the header-only renderer, without the
+        // out-of-line wrapper call.
+        auto inlineRenderer = SDL::InlineRenderer::CreateSoftwareRenderer(surface.get());
+
+        const auto spriteSize = 32;
+        auto sprite = renderer->CreateTexture(SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, spriteSize, spriteSize);
+        // Second texture for interleaved submissions.
+        auto otherSprite = renderer->CreateTexture(SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, spriteSize, spriteSize);
+        {
+            std::vector<uint32_t> pixels(spriteSize * spriteSize, 0x80FF8040u);
+            sprite->UpdateTexture(pixels.data(), spriteSize * 4);
+            otherSprite->UpdateTexture(pixels.data(), spriteSize * 4);
+        }
+        SDL::SpriteBatch spriteBatch(*renderer);
+
+        if(options.format == "csv")
+            std::cout << "case,batch,iterations,seconds,primitives_per_second,ns_per_primitive\n";
+
+        const std::size_t batches[] = {1, 16, 256, 4096};
+        for(auto batch : batches){
+            Random random(batch);
+            std::vector<SDL::Point> points(batch + 1);
+            std::vector<SDL::Rect> rects(batch);
+            std::vector<SDL::Rect> srcRects(batch, SDL::Rect{0, 0, spriteSize, spriteSize});
+            for(auto& point : points)
+                point = SDL::Point{random.Next(options.width), random.Next(options.height)};
+            for(auto& rect : rects)
+                rect = SDL::Rect{random.Next(options.width), random.Next(options.height), 1 + random.Next(32), 1 + random.Next(32)};
+
+            // The rects as world coordinates, zoomed out and scrolled each frame.
+            const auto zoom = 0.75f, scroll = -16.0f;
+            auto transform = [&](int value){ return static_cast<int>(std::nearbyint(value * zoom + scroll)); };
+            std::vector<SDL::Rect> transformedRects(batch);
+            SDL::RectBuffer worldRects, rectBuffer;
+            worldRects.Append(rects);
+
+            // A time series with 64 samples per batch entry across the width.
+            std::vector<SDL::Point> samples(batch * 64);
+            for(std::size_t i = 0; i < samples.size(); ++i)
+                samples[i] = SDL::Point{static_cast<int>(i * options.width / samples.size()), random.Next(options.height)};
+            SDL::PolylineReducer polylineReducer;
+
+            std::vector<std::pair<std::string, std::function<void()>>> cases{
+                {"points_single", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        renderer->RenderDrawPoint(points[i].x, points[i].y);
+                }},
+                {"points_batched", [&]{
+                    renderer->RenderDrawPoints(SDL::Span<const SDL::Point>(points.data(), batch));
+                }},
+                {"lines_single", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        renderer->RenderDrawLine(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y);
+                }},
+                {"lines_batched", [&]{
+                    renderer->RenderDrawLines(SDL::Span<const SDL::Point>(points.data(), batch + 1));
+                }},
+                {"lines_samples", [&]{
+                    renderer->RenderDrawLines(samples);
+                }},
+                {"lines_samples_reduced", [&]{
+                    polylineReducer.DrawLines(*renderer, samples);
+                }},
+                {"rects_single", [&]{
+                    for(auto& rect : rects)
+                        renderer->RenderDrawRect(rect);
+                }},
+                {"rects_batched", [&]{
+                    renderer->RenderDrawRects(rects);
+                }},
+                {"fills_single", [&]{
+                    for(auto& rect : rects)
+                        renderer->RenderFillRect(rect);
+                }},
+                {"fills_batched", [&]{
+                    renderer->RenderFillRects(rects);
+                }},
+                {"fills_transformed", [&]{
+                    for(std::size_t i = 0; i < batch; ++i){
+                        const auto& rect = rects[i];
+                        const auto x = transform(rect.x), y = transform(rect.y);
+                        transformedRects[i] = SDL::Rect{x, y, transform(rect.x + rect.w) - x, transform(rect.y + rect.h) - y};
+                    }
+                    renderer->RenderFillRects(transformedRects);
+                }},
+                {"fills_transformed_soa", [&]{
+                    rectBuffer = worldRects;
+                    rectBuffer.Scale(zoom, zoom, scroll, scroll);
+                    renderer->RenderFillRects(rectBuffer.Pack());
+                }},
+                {"copies_single", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        renderer->RenderCopy(*sprite, srcRects[i], rects[i]);
+                }},
+                {"copies_batched", [&]{
+                    renderer->RenderCopies(*sprite, srcRects, rects);
+                }},
+                {"sprites_interleaved", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        renderer->RenderCopy(i % 2 == 0 ? *sprite : *otherSprite, srcRects[i], rects[i]);
+                }},
+                {"sprites_batch", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        spriteBatch.Draw(i % 2 == 0 ? *sprite : *otherSprite, srcRects[i], rects[i]);
+                    spriteBatch.Flush();
+                }},
+                {"color_changes", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        renderer->SetRenderDrawColor(static_cast<uint8_t>(i), 0, 0, 255);
+                }},
+                {"color_redundant", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        renderer->SetRenderDrawColor(255, 255, 255, 255);
+                }},
+            };
+
+            for(auto buffered : {false, true}){
+                renderer->EnableCommandBuffer(buffered);
+                for(const auto& benchCase : cases){
+                    const auto name = benchCase.first + (buffered ? "_buffered" : "");
+                    if(!options.filter.empty() && name.find(options.filter) == std::string::npos)
+                        continue;
+                    Print(options, Run(options, name, batch, [&]{ renderer->RenderPresent(); }, benchCase.second));
+                }
+                renderer->EnableCommandBuffer(false);
+            }
+
+            std::vector<std::pair<std::string, std::function<void()>>> inlineCases{
+                {"points_single_inline", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        inlineRenderer.RenderDrawPoint(points[i].x, points[i].y);
+                }},
+                {"lines_single_inline", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        inlineRenderer.RenderDrawLine(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y);
+                }},
+                {"rects_single_inline", [&]{
+                    for(auto& rect : rects)
+                        inlineRenderer.RenderDrawRect(rect);
+                }},
+                {"fills_single_inline", [&]{
+                    for(auto& rect : rects)
+                        inlineRenderer.RenderFillRect(rect);
+                }},
+                {"color_changes_inline", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        inlineRenderer.SetRenderDrawColor(static_cast<uint8_t>(i), 0, 0, 255);
+                }},
+                {"color_redundant_inline", [&]{
+                    for(std::size_t i = 0; i < batch; ++i)
+                        inlineRenderer.SetRenderDrawColor(255, 255, 255, 255);
+                }},
+            };
+            for(const auto& benchCase : inlineCases){
+                if(!options.filter.empty() && benchCase.first.find(options.filter) == std::string::npos)
+                    continue;
+                Print(options, Run(options, benchCase.first, batch, [&]{ inlineRenderer.RenderPresent(); }, benchCase.second));
+            }
+        }
+    }catch(std::exception& e){
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
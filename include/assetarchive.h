@@ -0,0 +1,116 @@
+#ifndef SDL2PP_ASSETARCHIVE
+#define SDL2PP_ASSETARCHIVE
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SDL_rect.h>
+#include "rect.h"
+
+namespace SDL{
+
+	class MappedFile;
+	class Renderer;
+	class Texture;
+
+	// Single-file archive of images written by SDL2++_assetpack. The pixels
+	// are stored already converted to a texture format, so a texture is one
+	// upload straight from the mapped file. Sprites name rectangles inside the
+	// images, e.g. the regions of packed atlas pages; every packed input file
+	// gets one.
+	//
+	// Layout, little endian: a FileHeader, the FileImage and FileSprite
+	// tables, each sorted by name, the NUL-terminated names and the pixel
+	// blobs, each starting at a multiple of the header's alignment.
+	class AssetArchive{
+		public:
+			static const uint32_t Version = 1;
+
+			struct FileHeader{
+				char magic[4];	// "SPAK"
+				uint32_t version;
+				uint32_t imageCount;
+				uint32_t spriteCount;
+				uint32_t namesOffset;
+				uint32_t namesSize;
+				uint32_t alignment;
+				uint32_t reserved;
+			};
+
+			struct FileImage{
+				uint32_t name;	// Offset into the names.
+				uint32_t format;
+				int32_t width;
+				int32_t height;
+				int32_t pitch;
+				uint32_t flags;
+				uint64_t offset;
+			};
+
+			struct FileSprite{
+				uint32_t name;
+				uint32_t image;
+				int32_t x;
+				int32_t y;
+				int32_t w;
+				int32_t h;
+			};
+
+			enum ImageFlags : uint32_t{
+				ImageAlpha = 1
+			};
+
+			static const std::size_t NotFound = static_cast<std::size_t>(-1);
+
+			struct Image{
+				const char* name;
+				uint32_t format;
+				int width;
+				int height;
+				int pitch;
+				bool alpha;
+				const void* pixels;
+			};
+
+			struct Sprite{
+				const char* name;
+				std::size_t image;
+				Rect rect;
+			};
+
+			// Maps the archive and checks its tables. Throws Error.
+			explicit AssetArchive(const std::string& path);
+			~AssetArchive();
+
+			std::size_t GetImageCount() const{ return m_header->imageCount; }
+			std::size_t FindImage(const std::string& name) const;
+			Image GetImage(std::size_t index) const;
+
+			std::size_t GetSpriteCount() const{ return m_header->spriteCount; }
+			std::size_t FindSprite(const std::string& name) const;
+			Sprite GetSprite(std::size_t index) const;
+
+			// Creates a static texture on first use and keeps it. Blending is
+			// enabled for images with alpha.
+			std::shared_ptr<Texture> GetTexture(Renderer& renderer, std::size_t image);
+			// Asks the OS to start reading the pixels of an image.
+			void Prefetch(std::size_t image) const;
+			void UnloadTextures();
+
+		private:
+			const char* GetName(uint32_t offset) const{ return m_names + offset; }
+
+			std::shared_ptr<const MappedFile> m_file;
+			const FileHeader* m_header;
+			const FileImage* m_images;
+			const FileSprite* m_sprites;
+			const char* m_names;
+			std::vector<std::shared_ptr<Texture>> m_textures;
+			Renderer* m_renderer = nullptr;
+	};
+
+}
+
+#endif
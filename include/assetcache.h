@@ -0,0 +1,41 @@
+#ifndef SDL2PP_ASSETCACHE
+#define SDL2PP_ASSETCACHE
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace SDL{
+
+	class ImageAsset;
+
+	// Hands out one ImageAsset per file. Load() maps the file and reads its
+	// header, nothing more; pixels are decoded when the texture is first
+	// requested. Assets stay cached until Clear().
+	class AssetCache{
+		public:
+			// Paths are relative to root, which should end in a separator.
+			explicit AssetCache(std::string root = std::string());
+
+			// Throws Error if the file cannot be mapped or is no image.
+			std::shared_ptr<ImageAsset> Load(const std::string& path);
+			// nullptr unless loaded before.
+			std::shared_ptr<ImageAsset> Find(const std::string& path) const;
+
+			// Drops all textures but keeps the mappings, e.g. before the
+			// renderer is destroyed.
+			void UnloadTextures();
+			void Clear(){ m_assets.clear(); }
+
+			std::size_t GetAssetCount() const{ return m_assets.size(); }
+			std::size_t GetLoadedCount() const;
+
+		private:
+			std::string m_root;
+			std::unordered_map<std::string, std::shared_ptr<ImageAsset>> m_assets;
+	};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef SDL2PP_ATLAS
+#define SDL2PP_ATLAS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <SDL_rect.h>
+#include "rect.h"
+
+namespace SDL{
+
+	class Renderer;
+	class Texture;
+
+	// Skyline bottom-left rectangle packer. It only does bookkeeping and can
+	// be used without a renderer, e.g. by offline tools.
+	class SkylinePacker{
+		public:
+			SkylinePacker(int width, int height);
+
+			bool Insert(int w, int h, Rect& rect);
+			void Reset();
+
+			int GetWidth() const{ return m_width; }
+			int GetHeight() const{ return m_height; }
+			float GetOccupancy() const;
+
+		private:
+			struct Node{
+				int x;
+				int y;
+				int w;
+			};
+
+			bool Fit(std::size_t index, int w, int h, int& y) const;
+
+			int m_width;
+			int m_height;
+			long long m_usedArea = 0;
+			std::vector<Node> m_skyline;
+	};
+
+	// Packs many small images into a few large texture pages. Regions are
+	// addressed by handles that stay valid until they are erased. Space of
+	// erased regions is reused for later insertions; a page whose regions
+	// are all erased starts over empty.
+	class TextureAtlas{
+		public:
+			typedef uint32_t Handle;
+			static const Handle InvalidHandle = 0xFFFFFFFFu;
+
+			struct Region{
+				std::size_t page;
+				Rect rect;
+			};
+
+			// padding pixels around every region repeat its edge pixels, so
+			// filtered sampling does not bleed between neighbours. Unused space
+			// on a page is transparent.
+			TextureAtlas(Renderer& renderer, uint32_t format, int pageWidth, int pageHeight, int padding = 1);
+			~TextureAtlas();
+
+			Handle Insert(int w, int h, const void* pixels, int pitch);
+			void Erase(Handle handle);
+			void Clear();
+
+			const Region& GetRegion(Handle handle) const;
+			std::size_t GetPageCount() const{ return m_pages.size(); }
+			std::shared_ptr<Texture> GetPage(std::size_t page) const;
+			std::size_t GetRegionCount() const{ return m_liveRegions; }
+
+			// Queues a copy of a region; Flush() submits the queued copies page
+			// by page, so every page is bound once. Copies on the same page keep
+			// their order, copies on different pages may be reordered.
+			void RenderCopy(Handle handle, const Rect& dstRect);
+			void Flush();
+
+		private:
+			struct Page{
+				std::shared_ptr<Texture> texture;
+				SkylinePacker packer;
+				std::vector<Rect> freeRects;
+				std::size_t regions = 0;
+				std::vector<Rect> srcRects;
+				std::vector<Rect> dstRects;
+
+				Page(std::shared_ptr<Texture> texture, int width, int height);
+			};
+
+			struct Entry{
+				Region region;
+				bool live;
+			};
+
+			bool Allocate(Page& page, int w, int h, Rect& rect);
+			Page& AddPage();
+			// Uploads a w x h image into rect, which includes the padding.
+			void Upload(Page& page, const Rect& rect, int w, int h, const void* pixels, int pitch);
+
+			Renderer& m_renderer;
+			uint32_t m_format;
+			int m_pageWidth;
+			int m_pageHeight;
+			int m_padding;
+			std::vector<std::unique_ptr<Page>> m_pages;
+			std::vector<Entry> m_entries;
+			std::vector<Handle> m_freeHandles;
+			std::size_t m_liveRegions = 0;
+			// Padded images and the blank page on creation.
+			std::vector<uint8_t> m_scratch;
+	};
+
+}
+
+#endif
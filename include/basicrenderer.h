@@ -0,0 +1,245 @@
+#ifndef SDL2PP_BASICRENDERER
+#define SDL2PP_BASICRENDERER
+
+#include <cstdint>
+#include <utility>
+#include <glm/glm.hpp>
+#include <SDL_render.h>
+#include "error.h"
+#include "point.h"
+#include "profiler.h"
+#include "rect.h"
+#include "result.h"
+#include "span.h"
+#include "texture.h"
+
+namespace SDL{
+
+	// Error policies of BasicRenderer: what a failed SDL call turns into.
+	struct ThrowOnError{
+		typedef void ReturnType;
+		static void Check(int code){
+			if(code != 0)
+				throw Error();
+		}
+	};
+
+	struct ReturnResult{
+		typedef Result ReturnType;
+		static Result Check(int code){ return Result(code); }
+	};
+
+	// State policies: whether draw color and blend mode calls matching the
+	// last successful one are skipped.
+	class CacheState{
+		public:
+			bool HasDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a) const{
+				return m_drawColorKnown && m_drawColor == Pack(r, g, b, a);
+			}
+			void CacheDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+				m_drawColor = Pack(r, g, b, a);
+				m_drawColorKnown = true;
+			}
+			bool HasBlendMode(SDL_BlendMode blendMode) const{
+				return m_blendModeKnown && m_blendMode == blendMode;
+			}
+			void CacheBlendMode(SDL_BlendMode blendMode){
+				m_blendMode = blendMode;
+				m_blendModeKnown = true;
+			}
+			void InvalidateState(){
+				m_drawColorKnown = false;
+				m_blendModeKnown = false;
+			}
+
+		private:
+			static uint32_t Pack(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+				return r | g << 8 | b << 16 | static_cast<uint32_t>(a) << 24;
+			}
+
+			uint32_t m_drawColor = 0;
+			SDL_BlendMode m_blendMode = SDL_BLENDMODE_NONE;
+			bool m_drawColorKnown = false;
+			bool m_blendModeKnown = false;
+	};
+
+	class NoStateCache{
+		public:
+			bool HasDrawColor(uint8_t, uint8_t, uint8_t, uint8_t) const{ return false; }
+			void CacheDrawColor(uint8_t, uint8_t, uint8_t, uint8_t){}
+			bool HasBlendMode(SDL_BlendMode) const{ return false; }
+			void CacheBlendMode(SDL_BlendMode){}
+			void InvalidateState(){}
+	};
+
+	// Profile policies: whether calls are recorded as Profiler zones.
+	struct NoProfile{
+		struct Scope{
+			explicit Scope(Profiler::Zone){}
+		};
+		static void EndFrame(){}
+	};
+
+	struct ProfileZones{
+		typedef ProfileScope Scope;
+		static void EndFrame(){ Profiler::Get().EndFrame(); }
+	};
+
+#ifdef SDL2PP_PROFILE
+	typedef ProfileZones DefaultProfilePolicy;
+#else
+	typedef NoProfile DefaultProfilePolicy;
+#endif
+
+	// Header-only renderer for the drawing hot path. Every call is a direct,
+	// inlinable SDL call; the policies are picked at compile time and cost
+	// nothing when disabled. There is no command buffer, texture pool or
+	// render target tracking, use Renderer for those.
+	//
+	// Creation failures always throw, whatever the error policy.
+	template<typename ErrorPolicy = ThrowOnError, typename StatePolicy = CacheState, typename ProfilePolicy = DefaultProfilePolicy>
+	class BasicRenderer : private StatePolicy{
+		public:
+			typedef typename ErrorPolicy::ReturnType ReturnType;
+
+			explicit BasicRenderer(SDL_Renderer* renderer):m_renderer(renderer){}
+			~BasicRenderer(){
+				if(m_renderer != nullptr)
+					SDL_DestroyRenderer(m_renderer);
+			}
+
+			BasicRenderer(BasicRenderer&& other):StatePolicy(other), m_renderer(other.m_renderer){
+				other.m_renderer = nullptr;
+			}
+			BasicRenderer& operator=(BasicRenderer&& other){
+				std::swap(static_cast<StatePolicy&>(*this), static_cast<StatePolicy&>(other));
+				std::swap(m_renderer, other.m_renderer);
+				return *this;
+			}
+			BasicRenderer(const BasicRenderer&) = delete;
+			BasicRenderer& operator=(const BasicRenderer&) = delete;
+
+			// Renderer drawing into a memory surface, which has to outlive it.
+			static BasicRenderer CreateSoftwareRenderer(SDL_Surface* surface){
+				auto* renderer = SDL_CreateSoftwareRenderer(surface);
+				if(renderer == nullptr)
+					throw Error();
+				return BasicRenderer(renderer);
+			}
+
+			SDL_Renderer* Get() const{ return m_renderer; }
+
+			ReturnType RenderClear(){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderClear);
+				return ErrorPolicy::Check(SDL_RenderClear(m_renderer));
+			}
+
+			ReturnType RenderDrawPoint(int x, int y){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderDrawPoint);
+				return ErrorPolicy::Check(SDL_RenderDrawPoint(m_renderer, x, y));
+			}
+			ReturnType RenderDrawPoint(Point p){ return RenderDrawPoint(p.x, p.y); }
+			ReturnType RenderDrawPoint(glm::ivec2 p){ return RenderDrawPoint(p.x, p.y); }
+
+			ReturnType RenderDrawPoints(Span<const Point> points){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderDrawPoints);
+				return ErrorPolicy::Check(SDL_RenderDrawPoints(m_renderer, points.data(), points.size()));
+			}
+			ReturnType RenderDrawPoints(Span<const glm::ivec2> points){
+				return RenderDrawPoints(Span<const Point>(reinterpret_cast<const Point*>(points.data()), points.size()));
+			}
+
+			ReturnType RenderDrawLine(int x1, int y1, int x2, int y2){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderDrawLine);
+				return ErrorPolicy::Check(SDL_RenderDrawLine(m_renderer, x1, y1, x2, y2));
+			}
+			ReturnType RenderDrawLine(Point p1, Point p2){ return RenderDrawLine(p1.x, p1.y, p2.x, p2.y); }
+			ReturnType RenderDrawLine(glm::ivec2 p1, glm::ivec2 p2){ return RenderDrawLine(p1.x, p1.y, p2.x, p2.y); }
+
+			ReturnType RenderDrawLines(Span<const Point> points){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderDrawLines);
+				return ErrorPolicy::Check(SDL_RenderDrawLines(m_renderer, points.data(), points.size()));
+			}
+			ReturnType RenderDrawLines(Span<const glm::ivec2> points){
+				return RenderDrawLines(Span<const Point>(reinterpret_cast<const Point*>(points.data()), points.size()));
+			}
+
+			ReturnType RenderDrawRect(const Rect& rect){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderDrawRect);
+				return ErrorPolicy::Check(SDL_RenderDrawRect(m_renderer, &rect));
+			}
+
+			ReturnType RenderDrawRects(Span<const Rect> rects){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderDrawRects);
+				return ErrorPolicy::Check(SDL_RenderDrawRects(m_renderer, rects.data(), rects.size()));
+			}
+
+			ReturnType RenderFillRect(const Rect& rect){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderFillRect);
+				return ErrorPolicy::Check(SDL_RenderFillRect(m_renderer, &rect));
+			}
+
+			ReturnType RenderFillRects(Span<const Rect> rects){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderFillRects);
+				return ErrorPolicy::Check(SDL_RenderFillRects(m_renderer, rects.data(), rects.size()));
+			}
+
+			ReturnType RenderCopy(const Texture& texture){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderCopy);
+				return ErrorPolicy::Check(SDL_RenderCopy(m_renderer, texture.Get(), nullptr, nullptr));
+			}
+
+			ReturnType RenderCopy(const Texture& texture, const Rect& srcRect, const Rect& dstRect){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderCopy);
+				return ErrorPolicy::Check(SDL_RenderCopy(m_renderer, texture.Get(), &srcRect, &dstRect));
+			}
+
+			void RenderPresent(){
+				{
+					const typename ProfilePolicy::Scope scope(Profiler::Zone::RenderPresent);
+					SDL_RenderPresent(m_renderer);
+				}
+				ProfilePolicy::EndFrame();
+			}
+
+			ReturnType SetRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::SetRenderDrawColor);
+				if(this->HasDrawColor(r, g, b, a))
+					return ErrorPolicy::Check(0);
+				const auto code = SDL_SetRenderDrawColor(m_renderer, r, g, b, a);
+				if(code == 0)
+					this->CacheDrawColor(r, g, b, a);
+				return ErrorPolicy::Check(code);
+			}
+			ReturnType SetRenderDrawColor(glm::i8vec4 color){
+				return SetRenderDrawColor(color.r, color.g, color.b, color.a);
+			}
+
+			ReturnType SetRenderDrawBlendMode(SDL_BlendMode blendMode){
+				const typename ProfilePolicy::Scope scope(Profiler::Zone::SetRenderState);
+				if(this->HasBlendMode(blendMode))
+					return ErrorPolicy::Check(0);
+				const auto code = SDL_SetRenderDrawBlendMode(m_renderer, blendMode);
+				if(code == 0)
+					this->CacheBlendMode(blendMode);
+				return ErrorPolicy::Check(code);
+			}
+
+			// Call after changing renderer state through the C API.
+			void InvalidateRenderState(){
+				this->InvalidateState();
+			}
+
+		private:
+			SDL_Renderer* m_renderer;
+	};
+
+	typedef BasicRenderer<> InlineRenderer;
+	typedef BasicRenderer<ReturnResult> InlineRendererNoThrow;
+
+	static_assert(sizeof(BasicRenderer<ThrowOnError, NoStateCache, NoProfile>) == sizeof(SDL_Renderer*), "disabled policies must not add state");
+	static_assert(sizeof(Point) == sizeof(glm::ivec2), "glm::ivec2 has to match SDL_Point");
+
+}
+
+#endif
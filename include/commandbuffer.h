@@ -0,0 +1,91 @@
+#ifndef SDL2PP_COMMANDBUFFER
+#define SDL2PP_COMMANDBUFFER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SDL_rect.h>
+#include "point.h"
+#include "rect.h"
+
+class SDL_Texture;
+
+namespace SDL{
+
+	// Records draw color changes and primitives into a flat command stream
+	// so they can be submitted later with as few SDL calls as possible.
+	// Consecutive primitives of the same kind and color are coalesced into a
+	// single command, except lines: every DrawLine()/DrawLines() call keeps
+	// its own command, so blended output matches the unbuffered calls.
+	//
+	// The command and payload arenas keep their capacity across Reset(), so a
+	// steady-state frame records without touching the heap.
+	class RenderCommandBuffer{
+		public:
+			enum class Type : uint8_t{
+				Clear,
+				Points,
+				Lines,
+				Rects,
+				FillRects,
+				Copy
+			};
+
+			struct Color{
+				uint8_t r, g, b, a;
+			};
+
+			struct Command{
+				Type type;
+				Color color;
+				uint32_t first;
+				uint32_t count;
+				SDL_Texture* texture;
+			};
+
+			RenderCommandBuffer();
+			RenderCommandBuffer(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+
+			void SetDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+			Color GetDrawColor() const{ return m_color; }
+
+			void Clear();
+
+			void DrawPoint(int x, int y);
+			void DrawPoints(const Point* points, std::size_t count);
+
+			void DrawLine(int x1, int y1, int x2, int y2);
+			void DrawLines(const Point* points, std::size_t count);
+
+			void DrawRect(const Rect& rect);
+			void DrawRects(const Rect* rects, std::size_t count);
+
+			void FillRect(const Rect& rect);
+			void FillRects(const Rect* rects, std::size_t count);
+
+			// Copies are stored as source/destination rect pairs. Consecutive
+			// copies of the same texture share one command. The texture has to
+			// stay alive until the buffer is submitted.
+			void Copy(SDL_Texture* texture, const Rect& srcRect, const Rect& dstRect);
+			void Copy(SDL_Texture* texture, const Rect* srcRects, const Rect* dstRects, std::size_t count);
+
+			void Reset();
+			bool Empty() const{ return m_commands.empty(); }
+
+			const std::vector<Command>& GetCommands() const{ return m_commands; }
+			const Point* GetPoints(const Command& command) const{ return m_points.data() + command.first; }
+			const Rect* GetRects(const Command& command) const{ return m_rects.data() + command.first; }
+
+		private:
+			Command* Extend(Type type, SDL_Texture* texture = nullptr);
+			void Begin(Type type, uint32_t first, SDL_Texture* texture = nullptr);
+
+			Color m_color{0, 0, 0, 255};
+			std::vector<Command> m_commands;
+			std::vector<Point> m_points;
+			std::vector<Rect> m_rects;
+	};
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SDL2PP_DIRTYPRESENTER
+#define SDL2PP_DIRTYPRESENTER
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "dirtyrects.h"
+#include "rect.h"
+#include "renderer.h"
+
+namespace SDL{
+
+	class Texture;
+	class Window;
+
+	// Keeps the last frame of a window and only redraws and presents the
+	// regions that were invalidated since. Present() calls the draw function
+	// once per dirty rect with the clip rect set to it; it has to repaint
+	// everything inside the rect, background included. Paint the background
+	// with RenderFillRect(rect), not RenderClear(): SDL clears ignoring the
+	// clip rect, which would wipe the kept frame outside the dirty rects.
+	//
+	// Surface draws into the window surface with a software renderer and
+	// copies just the dirty rects to the screen. Target keeps the frame in a
+	// render target texture of the window's renderer and copies all of it to
+	// the back buffer, which costs one blit instead of redrawing the scene.
+	class DirtyPresenter{
+		public:
+			enum class Mode : uint8_t{
+				Surface,
+				Target
+			};
+
+			typedef std::function<void(Renderer& renderer, const Rect& rect)> DrawFunction;
+
+			// Surface replaces the window's renderer with a software renderer
+			// using the given backend. Target needs the window's renderer to
+			// support render targets.
+			DirtyPresenter(Window& window, Mode mode, SoftwareBackend backend = SoftwareBackend::SDL, std::size_t maxRects = 16);
+			~DirtyPresenter();
+
+			DirtyPresenter(const DirtyPresenter&) = delete;
+			DirtyPresenter& operator=(const DirtyPresenter&) = delete;
+
+			Mode GetMode() const{ return m_mode; }
+			// Replaced by Resize() in Surface mode.
+			std::shared_ptr<Renderer> GetRenderer() const{ return m_renderer; }
+
+			void Invalidate(const Rect& rect);
+			// Also needed after SDL_RENDER_TARGETS_RESET in Target mode.
+			void InvalidateAll();
+			bool IsDirty() const{ return !m_dirty.Empty(); }
+			const DirtyRects& GetDirtyRects() const{ return m_dirty; }
+
+			// Redraws the dirty rects and presents them. Returns false and
+			// presents nothing if no region changed.
+			bool Present(const DrawFunction& draw);
+
+			// Call after the window size changed. Everything is redrawn.
+			void Resize();
+
+			// Pixels redrawn by the last Present().
+			long long GetLastRedrawArea() const{ return m_lastArea; }
+
+		private:
+			void CreateTarget();
+
+			Window& m_window;
+			Mode m_mode;
+			SoftwareBackend m_backend;
+			std::shared_ptr<Renderer> m_renderer;
+			std::shared_ptr<Texture> m_target;
+			DirtyRects m_dirty;
+			long long m_lastArea = 0;
+	};
+
+}
+
+#endif
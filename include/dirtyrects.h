@@ -0,0 +1,52 @@
+#ifndef SDL2PP_DIRTYRECTS
+#define SDL2PP_DIRTYRECTS
+
+#include <cstddef>
+#include <vector>
+#include <SDL_rect.h>
+#include "rect.h"
+
+namespace SDL{
+
+	// Set of changed regions inside a width x height area. The stored rects
+	// never intersect: only the parts of an added rect outside them are
+	// added, each merged with a touching rect if their union is mostly
+	// dirty anyway. Once more than maxRects remain, the pair whose union
+	// wastes the least area is merged.
+	class DirtyRects{
+		public:
+			DirtyRects(int width, int height, std::size_t maxRects = 16);
+
+			void Add(const Rect& rect);
+			void Add(const DirtyRects& other);
+			void AddAll();
+			void Clear(){ m_rects.clear(); }
+
+			void Resize(int width, int height);
+
+			bool Empty() const{ return m_rects.empty(); }
+			const std::vector<Rect>& GetRects() const{ return m_rects; }
+			long long GetArea() const;
+			Rect GetBounds() const;
+
+			int GetWidth() const{ return m_width; }
+			int GetHeight() const{ return m_height; }
+
+		private:
+			// Adds the parts of rect outside the stored rects.
+			void Insert(Rect rect);
+			// Adds a rect that overlaps none of the stored ones.
+			void Merge(Rect rect);
+			// Merges rect with every rect it overlaps.
+			void Absorb(Rect rect);
+			void Reduce();
+
+			int m_width;
+			int m_height;
+			std::size_t m_maxRects;
+			std::vector<Rect> m_rects;
+	};
+
+}
+
+#endif
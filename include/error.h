@@ -2,12 +2,14 @@
 #define SDL2PP_ERROR
 
 #include <stdexcept>
+#include <string>
 
 namespace SDL{
 	class Error : public std::runtime_error{
 		public:
 			static std::string Get();
 			Error();
+			Error(const std::string& message);
 			virtual ~Error();
 	};
 }
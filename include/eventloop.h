@@ -0,0 +1,118 @@
+#ifndef SDL2PP_EVENTLOOP
+#define SDL2PP_EVENTLOOP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <SDL_events.h>
+
+namespace SDL{
+
+	// Bounded lock-free ring of events. Any number of threads may push, one
+	// thread pops. Every slot carries a sequence number telling producers
+	// and the consumer whose turn it is, so neither side takes a lock.
+	class EventQueue{
+		public:
+			// The capacity is rounded up to a power of two.
+			explicit EventQueue(std::size_t capacity);
+
+			EventQueue(const EventQueue&) = delete;
+			EventQueue& operator=(const EventQueue&) = delete;
+
+			// Returns false and drops the event if the ring is full.
+			bool Push(const SDL_Event& event);
+			// Like Push(), but leaves a rejected event to the caller instead of
+			// counting it as dropped.
+			bool TryPush(const SDL_Event& event);
+			// Consumer thread only. Moves up to max events into events and
+			// returns how many.
+			std::size_t Pop(SDL_Event* events, std::size_t max);
+
+			std::size_t GetCapacity() const{ return m_mask + 1; }
+			// Approximate while other threads push or pop.
+			std::size_t GetSize() const;
+			std::size_t GetDroppedCount() const{ return m_dropped.load(std::memory_order_relaxed); }
+
+		private:
+			struct Slot{
+				std::atomic<std::size_t> sequence;
+				SDL_Event event;
+			};
+
+			std::unique_ptr<Slot[]> m_slots;
+			std::size_t m_mask;
+			// Producers and the consumer write these from different threads.
+			std::atomic<std::size_t> m_tail{0};
+			char m_tailPadding[64];
+			std::atomic<std::size_t> m_head{0};
+			// Producers bump this; keep it off the consumer's line.
+			char m_headPadding[64];
+			std::atomic<std::size_t> m_dropped{0};
+	};
+
+	// Moves SDL's events into an EventQueue in batches and dispatches them on
+	// the consumer side through a table of handlers keyed by event type.
+	//
+	// SDL reads OS events only on the thread that initialized video. To
+	// decouple input from frame time, render on another thread and let the
+	// main thread sit in Run(), which pumps as soon as events arrive. The
+	// render or logic thread calls Dispatch() whenever it wants input, as
+	// often as it likes. A single-threaded loop calls Pump() and Dispatch()
+	// once per frame.
+	class EventLoop{
+		public:
+			typedef std::function<void(const SDL_Event& event)> Handler;
+
+			explicit EventLoop(std::size_t capacity = 4096);
+			~EventLoop();
+
+			EventLoop(const EventLoop&) = delete;
+			EventLoop& operator=(const EventLoop&) = delete;
+
+			// Pump side, on the thread that initialized video. Returns the
+			// number of events queued. Events that do not fit into the queue
+			// are held back and queued first by the next pump.
+			std::size_t Pump();
+			// Waits for events and pumps them until Quit() is called.
+			void Run(int timeoutMs = 100);
+			// Any thread. Wakes Run() and makes it return.
+			void Quit();
+			bool IsRunning() const{ return !m_quit.load(std::memory_order_acquire); }
+
+			// Any thread, e.g. for custom events from workers.
+			bool Push(const SDL_Event& event){ return m_queue.Push(event); }
+
+			// Consumer side. Handlers must only be changed from the consumer
+			// thread.
+			void SetHandler(uint32_t type, Handler handler);
+			void RemoveHandler(uint32_t type);
+			// Called for events without a handler of their own.
+			void SetDefaultHandler(Handler handler);
+
+			// Drains up to max queued events without dispatching them.
+			std::size_t Poll(SDL_Event* events, std::size_t max){ return m_queue.Pop(events, max); }
+			// Drains the queue and calls the handlers. Returns the number of
+			// events taken.
+			std::size_t Dispatch();
+
+			// Events lost because the queue was full.
+			std::size_t GetDroppedCount() const{ return m_queue.GetDroppedCount(); }
+
+		private:
+			EventQueue m_queue;
+			// Pump side. Taken from SDL but not yet queued, at most one batch.
+			std::vector<SDL_Event> m_overflow;
+			std::unordered_map<uint32_t, Handler> m_handlers;
+			Handler m_defaultHandler;
+			std::atomic<bool> m_quit{false};
+			// Private event type Quit() pushes to wake Run().
+			uint32_t m_wakeEvent;
+	};
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef SDL2PP_FRAMESCHEDULER
+#define SDL2PP_FRAMESCHEDULER
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace SDL{
+
+	// Paces a render loop. BeginFrame() measures the time since the previous
+	// frame with the performance counter and tells how many fixed simulation
+	// steps are due; rendering then interpolates between the last two steps
+	// with GetAlpha(). EndFrame() sleeps off the rest of the frame when a
+	// frame rate cap is set and records the frame for the statistics.
+	//
+	//   while(running){
+	//       for(auto steps = scheduler.BeginFrame(); steps > 0; --steps)
+	//           Update(scheduler.GetFixedTimestep());
+	//       Render(scheduler.GetAlpha());
+	//       renderer->RenderPresent();
+	//       scheduler.EndFrame();
+	//   }
+	class FrameScheduler{
+		public:
+			enum class SwapInterval : int8_t{
+				Adaptive = -1,
+				Immediate = 0,
+				Vsync = 1
+			};
+
+			// Frame times in seconds over the last HistoryLength frames.
+			// Jitter is their standard deviation.
+			struct Stats{
+				std::size_t frames = 0;
+				double mean = 0.0;
+				double jitter = 0.0;
+				double min = 0.0;
+				double max = 0.0;
+				// Time from BeginFrame() to EndFrame() without the sleep.
+				double meanWork = 0.0;
+				// Frames longer than 1.5 budgets since construction.
+				uint32_t missed = 0;
+			};
+
+			static const std::size_t HistoryLength = 240;
+
+			FrameScheduler();
+
+			// Sets the swap interval of the current OpenGL context, falling
+			// back from Adaptive to Vsync to Immediate. Returns the interval
+			// in effect. Renderers other than OpenGL keep their own setting.
+			static SwapInterval SetSwapInterval(SwapInterval interval);
+
+			// Seconds per simulation step; 0 makes BeginFrame() return 0.
+			void SetFixedTimestep(double seconds);
+			double GetFixedTimestep() const{ return m_timestep; }
+			// Steps run at most per frame. Time beyond that is dropped so a
+			// slow frame can't make the next one slower.
+			void SetMaxStepsPerFrame(int steps){ m_maxSteps = steps; }
+
+			// Frames per second EndFrame() sleeps down to; 0 for no cap. With a
+			// coarse system timer frames may run slightly long rather than
+			// spinning the CPU.
+			void SetFrameRateCap(double fps);
+			// Frame time the missed frame count is checked against; 0 counts
+			// nothing.
+			void SetFrameBudget(double seconds){ m_budget = seconds; }
+
+			// Returns the number of fixed steps due.
+			int BeginFrame();
+			void EndFrame();
+
+			// Seconds since the previous BeginFrame(), 0 on the first frame.
+			double GetDeltaTime() const{ return m_delta; }
+			// Position in [0, 1) between the last step and the next one.
+			double GetAlpha() const{ return m_timestep > 0.0 ? m_accumulator / m_timestep : 0.0; }
+
+			Stats GetStats() const;
+
+		private:
+			double Seconds(uint64_t ticks) const{ return static_cast<double>(ticks) / m_frequency; }
+			void SleepUntil(uint64_t deadline);
+
+			double m_frequency;
+			uint64_t m_frameStart = 0;
+			bool m_started = false;
+			double m_delta = 0.0;
+
+			double m_timestep = 0.0;
+			double m_accumulator = 0.0;
+			int m_maxSteps = 5;
+
+			uint64_t m_capTicks = 0;
+			double m_budget = 0.0;
+			// How long SDL_Delay(1) tends to take, at most 2 ms. The last part
+			// of a wait shorter than this is spent yielding instead.
+			double m_sleepMargin = 0.0015;
+
+			std::array<float, HistoryLength> m_frameTimes{};
+			std::array<float, HistoryLength> m_workTimes{};
+			std::size_t m_history = 0;
+			std::size_t m_next = 0;
+			uint32_t m_missed = 0;
+	};
+
+}
+
+#endif
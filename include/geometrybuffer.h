@@ -0,0 +1,158 @@
+#ifndef SDL2PP_GEOMETRYBUFFER
+#define SDL2PP_GEOMETRYBUFFER
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <SDL_rect.h>
+#include "point.h"
+#include "rect.h"
+#include "span.h"
+
+namespace SDL{
+
+	// Storage of PointBuffer and RectBuffer: one int array per component,
+	// each starting on a 64 byte boundary. The capacity is a multiple of
+	// Granularity and the elements past the size stay allocated, so the SIMD
+	// kernels run over whole vectors without tails.
+	class CoordinateStorage{
+		public:
+			static const std::size_t Granularity = 16;
+
+			explicit CoordinateStorage(int components);
+			CoordinateStorage(const CoordinateStorage& other);
+			CoordinateStorage(CoordinateStorage&& other) noexcept;
+			// Reuses the allocation when it is large enough.
+			CoordinateStorage& operator=(const CoordinateStorage& other);
+			CoordinateStorage& operator=(CoordinateStorage&& other) noexcept;
+
+			std::size_t GetSize() const{ return m_size; }
+			std::size_t GetCapacity() const{ return m_capacity; }
+			int* GetComponent(int component) const{ return m_data + component * m_capacity; }
+
+			void Reserve(std::size_t capacity);
+			// New elements are zero.
+			void Resize(std::size_t size);
+			void Clear(){ m_size = 0; }
+			// Adds count elements and returns the index of the first.
+			std::size_t Grow(std::size_t count){
+				if(m_size + count > m_capacity)
+					Reserve(m_size + count > 2 * m_capacity ? m_size + count : 2 * m_capacity);
+				const auto first = m_size;
+				m_size += count;
+				return first;
+			}
+			// Drops elements, e.g. after compacting in place.
+			void Truncate(std::size_t size){ m_size = size; }
+
+		private:
+			int m_components;
+			std::unique_ptr<unsigned char[]> m_allocation;
+			int* m_data = nullptr;
+			std::size_t m_size = 0;
+			std::size_t m_capacity = 0;
+	};
+
+	// Points stored as separate x and y arrays, so transforming a large batch
+	// is a few passes of SIMD over contiguous ints instead of a loop over
+	// SDL_Points one field at a time. Pack() turns them back into SDL_Points
+	// for the batch draw calls:
+	//
+	//   points.Translate(-camera.x, -camera.y);
+	//   renderer.RenderDrawPoints(points.Pack());
+	class PointBuffer{
+		public:
+			PointBuffer():m_storage(2){}
+
+			std::size_t GetSize() const{ return m_storage.GetSize(); }
+			bool IsEmpty() const{ return GetSize() == 0; }
+			void Reserve(std::size_t capacity){ m_storage.Reserve(capacity); }
+			void Resize(std::size_t size){ m_storage.Resize(size); }
+			void Clear(){ m_storage.Clear(); }
+
+			void PushBack(int x, int y){
+				const auto index = m_storage.Grow(1);
+				GetX()[index] = x;
+				GetY()[index] = y;
+			}
+			void PushBack(const Point& point){ PushBack(point.x, point.y); }
+			void Append(Span<const Point> points);
+
+			int* GetX(){ return m_storage.GetComponent(0); }
+			int* GetY(){ return m_storage.GetComponent(1); }
+			const int* GetX() const{ return m_storage.GetComponent(0); }
+			const int* GetY() const{ return m_storage.GetComponent(1); }
+			Point GetPoint(std::size_t index) const{ return Point{GetX()[index], GetY()[index]}; }
+
+			void Translate(int dx, int dy);
+			// x * scaleX + offsetX, rounded to the nearest integer.
+			void Scale(float scaleX, float scaleY, float offsetX = 0.0f, float offsetY = 0.0f);
+			// Removes the points outside rect, keeping the order of the rest.
+			void Clip(const Rect& rect);
+			// Smallest rect containing every point; empty without points.
+			Rect GetBoundingBox() const;
+
+			// The points as SDL_Points, valid until the next Pack(). The
+			// buffer is kept, so packing every frame does not allocate.
+			Span<const Point> Pack();
+
+		private:
+			CoordinateStorage m_storage;
+			std::vector<Point> m_packed;
+	};
+
+	// Rects stored as separate x, y, w and h arrays; see PointBuffer.
+	class RectBuffer{
+		public:
+			RectBuffer():m_storage(4){}
+
+			std::size_t GetSize() const{ return m_storage.GetSize(); }
+			bool IsEmpty() const{ return GetSize() == 0; }
+			void Reserve(std::size_t capacity){ m_storage.Reserve(capacity); }
+			void Resize(std::size_t size){ m_storage.Resize(size); }
+			void Clear(){ m_storage.Clear(); }
+
+			void PushBack(int x, int y, int w, int h){
+				const auto index = m_storage.Grow(1);
+				GetX()[index] = x;
+				GetY()[index] = y;
+				GetW()[index] = w;
+				GetH()[index] = h;
+			}
+			void PushBack(const Rect& rect){ PushBack(rect.x, rect.y, rect.w, rect.h); }
+			void Append(Span<const Rect> rects);
+
+			int* GetX(){ return m_storage.GetComponent(0); }
+			int* GetY(){ return m_storage.GetComponent(1); }
+			int* GetW(){ return m_storage.GetComponent(2); }
+			int* GetH(){ return m_storage.GetComponent(3); }
+			const int* GetX() const{ return m_storage.GetComponent(0); }
+			const int* GetY() const{ return m_storage.GetComponent(1); }
+			const int* GetW() const{ return m_storage.GetComponent(2); }
+			const int* GetH() const{ return m_storage.GetComponent(3); }
+			Rect GetRect(std::size_t index) const{ return Rect{GetX()[index], GetY()[index], GetW()[index], GetH()[index]}; }
+
+			void Translate(int dx, int dy);
+			// Scales the edges like PointBuffer::Scale() and takes the size
+			// from the rounded edges, so rects that touched still touch.
+			// Expects positive factors.
+			void Scale(float scaleX, float scaleY, float offsetX = 0.0f, float offsetY = 0.0f);
+			// Intersects every rect with rect and removes the empty results,
+			// keeping the order of the rest.
+			void Clip(const Rect& rect);
+			// Smallest rect containing every rect, empty ones included; empty
+			// without rects.
+			Rect GetBoundingBox() const;
+
+			// The rects as SDL_Rects, valid until the next Pack(). The buffer
+			// is kept, so packing every frame does not allocate.
+			Span<const Rect> Pack();
+
+		private:
+			CoordinateStorage m_storage;
+			std::vector<Rect> m_packed;
+	};
+
+}
+
+#endif
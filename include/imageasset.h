@@ -0,0 +1,60 @@
+#ifndef SDL2PP_IMAGEASSET
+#define SDL2PP_IMAGEASSET
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace SDL{
+
+	class MappedFile;
+	class Renderer;
+	class Texture;
+
+	// An image stored in a memory-mapped file: uncompressed BMP (1, 4, 8, 16
+	// bit 565, 24 and 32 bit) or QOI. Construction only checks the header;
+	// the pixels are decoded from the mapping into a texture the first time
+	// GetTexture() is called, so unused images cost neither memory nor reads.
+	class ImageAsset{
+		public:
+			enum class Format : uint8_t{
+				BMP,
+				QOI
+			};
+
+			// The image is the byte range [offset, offset + size) of the file.
+			// Throws Error if it is not a supported image.
+			ImageAsset(std::shared_ptr<const MappedFile> file, std::size_t offset, std::size_t size);
+			explicit ImageAsset(std::shared_ptr<const MappedFile> file);
+
+			Format GetFormat() const{ return m_format; }
+			int GetWidth() const{ return m_width; }
+			int GetHeight() const{ return m_height; }
+			bool HasAlpha() const{ return m_alpha; }
+
+			// Decodes into ARGB8888 rows.
+			void Decode(void* pixels, int pitch) const;
+
+			// Creates a static ARGB8888 texture through
+			// Renderer::CreateTexture() on first use and keeps it. Blending is
+			// enabled for images with alpha.
+			std::shared_ptr<Texture> GetTexture(Renderer& renderer);
+			bool IsLoaded() const{ return m_texture != nullptr; }
+			// Drops the texture; the next GetTexture() decodes again.
+			void Unload();
+
+		private:
+			std::shared_ptr<const MappedFile> m_file;
+			const uint8_t* m_data;
+			std::size_t m_size;
+			Format m_format;
+			int m_width;
+			int m_height;
+			bool m_alpha;
+			std::shared_ptr<Texture> m_texture;
+			Renderer* m_renderer = nullptr;
+	};
+
+}
+
+#endif
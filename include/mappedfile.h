@@ -0,0 +1,39 @@
+#ifndef SDL2PP_MAPPEDFILE
+#define SDL2PP_MAPPEDFILE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SDL{
+
+	// Read-only memory mapping of a whole file. Opening costs no reads; the
+	// OS pages the contents in when they are first touched and can drop them
+	// again under memory pressure, since they are backed by the file.
+	class MappedFile{
+		public:
+			// Throws Error if the file cannot be opened or mapped.
+			explicit MappedFile(const std::string& path);
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+			~MappedFile();
+
+			const uint8_t* GetData() const{ return m_data; }
+			std::size_t GetSize() const{ return m_size; }
+			const std::string& GetPath() const{ return m_path; }
+
+			// Asks the OS to start reading a range that will be needed soon.
+			void Prefetch(std::size_t offset, std::size_t size) const;
+
+		private:
+			std::string m_path;
+			const uint8_t* m_data = nullptr;
+			std::size_t m_size = 0;
+#ifdef _WIN32
+			void* m_mapping = nullptr;
+#endif
+	};
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef SDL2PP_PIXELCONVERT
+#define SDL2PP_PIXELCONVERT
+
+#include <cstdint>
+
+namespace SDL{
+
+	// Converts rows of pixels between the common packed formats: the 32-bit
+	// formats with 8-bit channels (ARGB8888, RGBA8888, ABGR8888, BGRA8888,
+	// RGB888, BGR888), RGB24, BGR24 and RGB565, in any combination. A missing
+	// source alpha becomes opaque. Byte reordering runs on SSSE3 or AVX2
+	// shuffles, RGB565 on SSE2, picked once at runtime.
+	//
+	// An instance is prepared for one format pair and converts row by row,
+	// e.g. while streaming decoded video into a locked texture.
+	class PixelConvert{
+		public:
+			static bool Supports(uint32_t srcFormat, uint32_t dstFormat);
+			// "avx2", "ssse3", "sse2" or "scalar".
+			static const char* GetKernelName();
+			// Switches every conversion to the scalar kernels, so the SIMD
+			// ones can be checked against them. Not while converting.
+			static void ForceScalarKernels(bool force);
+
+			// Pairs without a kernel go through SDL_ConvertPixels. src may be
+			// dst if both formats have the same bytes per pixel and the
+			// pitches match.
+			static void Convert(int w, int h, uint32_t srcFormat, const void* src, int srcPitch, uint32_t dstFormat, void* dst, int dstPitch);
+
+			// Planar YUV as taken by SDL_UpdateYUVTexture. IYUV and YV12 have
+			// three planes; for NV12 and NV21 uPlane is the interleaved
+			// chroma plane and vPlane is unused. BT.601 limited range, SDL's
+			// default below HD. The RGB side may be any supported format.
+			static void ConvertYUVToRGB(int w, int h, uint32_t yuvFormat,
+			                            const uint8_t* yPlane, int yPitch,
+			                            const uint8_t* uPlane, int uPitch,
+			                            const uint8_t* vPlane, int vPitch,
+			                            uint32_t dstFormat, void* dst, int dstPitch);
+			// Chroma is the average of each 2x2 block.
+			static void ConvertRGBToYUV(int w, int h, uint32_t srcFormat, const void* src, int srcPitch,
+			                            uint32_t yuvFormat,
+			                            uint8_t* yPlane, int yPitch,
+			                            uint8_t* uPlane, int uPitch,
+			                            uint8_t* vPlane, int vPitch);
+
+			// Throws std::invalid_argument unless Supports().
+			PixelConvert(uint32_t srcFormat, uint32_t dstFormat);
+
+			// In place if src == dst and both formats have the same size.
+			void ConvertRow(const void* src, void* dst, int width) const;
+			void Convert(int w, int h, const void* src, int srcPitch, void* dst, int dstPitch) const;
+
+			uint32_t GetSourceFormat() const{ return m_srcFormat; }
+			uint32_t GetTargetFormat() const{ return m_dstFormat; }
+
+			// Byte permutation between two formats without RGB565: for each
+			// destination byte the source byte, or -1 for opaque alpha.
+			struct Shuffle{
+				int8_t map[4];
+				int srcBytes;
+				int dstBytes;
+				// The same for four pixels at once, for pshufb.
+				uint8_t mask[16];
+				uint8_t fill[16];
+			};
+
+		private:
+			enum class Kind : uint8_t{
+				Copy,
+				Shuffle,
+				From565,
+				To565
+			};
+
+			uint32_t m_srcFormat;
+			uint32_t m_dstFormat;
+			Kind m_kind;
+			int m_srcBytes;
+			int m_dstBytes;
+			// From565: ARGB8888 to the target; To565: source to ARGB8888.
+			Shuffle m_shuffle;
+	};
+
+}
+
+#endif
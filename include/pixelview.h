@@ -0,0 +1,87 @@
+#ifndef SDL2PP_PIXELVIEW
+#define SDL2PP_PIXELVIEW
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <SDL_rect.h>
+#include "rect.h"
+#include "span.h"
+
+namespace SDL{
+
+	// Typed view of a pitched pixel buffer, e.g. a locked surface. Pixel is
+	// the integer type of one pixel (uint32_t for the 32-bit formats,
+	// uint16_t for 16-bit ones). Iterating the view yields one Span per row.
+	template<typename Pixel>
+	class PixelView{
+		public:
+			class RowIterator{
+				public:
+					typedef std::forward_iterator_tag iterator_category;
+					typedef Span<Pixel> value_type;
+					typedef std::ptrdiff_t difference_type;
+					typedef const Span<Pixel>* pointer;
+					typedef Span<Pixel> reference;
+
+					RowIterator(uint8_t* row, int width, int pitch):m_row(row), m_width(width), m_pitch(pitch){}
+
+					Span<Pixel> operator*() const{ return Span<Pixel>(reinterpret_cast<Pixel*>(m_row), m_width); }
+					RowIterator& operator++(){ m_row += m_pitch; return *this; }
+					RowIterator operator++(int){ auto old = *this; m_row += m_pitch; return old; }
+					bool operator==(const RowIterator& other) const{ return m_row == other.m_row; }
+					bool operator!=(const RowIterator& other) const{ return m_row != other.m_row; }
+
+				private:
+					uint8_t* m_row;
+					int m_width;
+					int m_pitch;
+			};
+
+			PixelView():m_pixels(nullptr), m_width(0), m_height(0), m_pitch(0){}
+			PixelView(void* pixels, int width, int height, int pitch):m_pixels(static_cast<uint8_t*>(pixels)), m_width(width), m_height(height), m_pitch(pitch){}
+
+			int GetWidth() const{ return m_width; }
+			int GetHeight() const{ return m_height; }
+			// In bytes; may be larger than a row of pixels.
+			int GetPitch() const{ return m_pitch; }
+			Pixel* GetPixels() const{ return reinterpret_cast<Pixel*>(m_pixels); }
+
+			Pixel* GetRow(int y) const{ return reinterpret_cast<Pixel*>(m_pixels + y * m_pitch); }
+			Pixel& operator()(int x, int y) const{ return GetRow(y)[x]; }
+
+			RowIterator begin() const{ return RowIterator(m_pixels, m_width, m_pitch); }
+			RowIterator end() const{ return RowIterator(m_pixels + m_height * m_pitch, m_width, m_pitch); }
+
+			// The part of the view inside rect, which is clipped to the view.
+			PixelView SubView(const Rect& rect) const{
+				const auto x0 = std::max(rect.x, 0), y0 = std::max(rect.y, 0);
+				const auto x1 = std::min(rect.x + rect.w, m_width), y1 = std::min(rect.y + rect.h, m_height);
+				if(x1 <= x0 || y1 <= y0)
+					return PixelView();
+				return PixelView(m_pixels + y0 * m_pitch + x0 * static_cast<int>(sizeof(Pixel)), x1 - x0, y1 - y0, m_pitch);
+			}
+
+			// Largest power of two up to 64 that divides the address of every
+			// row, so SIMD code can tell whether aligned loads are safe.
+			std::size_t GetRowAlignment() const{
+				const auto bits = reinterpret_cast<uintptr_t>(m_pixels) | static_cast<uintptr_t>(m_pitch) | 64;
+				return static_cast<std::size_t>(bits & (~bits + 1));
+			}
+
+			void Fill(Pixel value) const{
+				for(auto row : *this)
+					std::fill(row.begin(), row.end(), value);
+			}
+
+		private:
+			uint8_t* m_pixels;
+			int m_width;
+			int m_height;
+			int m_pitch;
+	};
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef SDL2PP_POLYLINEREDUCER
+#define SDL2PP_POLYLINEREDUCER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SDL_rect.h>
+#include "point.h"
+#include "rect.h"
+#include "span.h"
+
+namespace SDL{
+
+	class Renderer;
+
+	// Shrinks polylines with far more points than pixels, e.g. time series,
+	// before RenderDrawLines(). Segments are clipped to a rect, and each
+	// visit of the line to a pixel column collapses to at most four points:
+	// the first, the lowest, the highest and the last, in their original
+	// order. They cover the same pixels of the column, so the line looks the
+	// same while the output is bounded by the width of the rect instead of
+	// the number of samples.
+	//
+	// Clipping uses SDL_IntersectRectAndLine(), like SDL's software
+	// renderer. Leaving the rect ends a run, so the result can be several
+	// polylines.
+	class PolylineReducer{
+		public:
+			// Replaces the result with points clipped to clip, a rect in draw
+			// coordinates such as Renderer::RenderGetVisibleRect().
+			void Reduce(Span<const Point> points, const Rect& clip);
+
+			std::size_t GetRunCount() const{ return m_runEnds.size(); }
+			Span<const Point> GetRun(std::size_t index) const;
+			// Points of all runs.
+			std::size_t GetSize() const{ return m_points.size(); }
+
+			// Reduces points against the renderer's visible rect and draws
+			// each run with RenderDrawLines(). Returns the number of points
+			// submitted.
+			std::size_t DrawLines(Renderer& renderer, Span<const Point> points);
+
+		private:
+			// The current pixel column; min and max keep the first occurrence.
+			struct Column{
+				int x;
+				int firstY;
+				int minY;
+				int maxY;
+				int lastY;
+				bool minFirst;
+			};
+
+			void BeginRun();
+			void EndRun();
+			void AddPoint(const Point& point){ AddColumn(Column{point.x, point.y, point.y, point.y, point.y, true}); }
+			// Points [first, last) of the input, all inside the clip rect.
+			void AddPoints(const Point* points, std::size_t first, std::size_t last);
+			void AddColumn(const Column& column);
+			void FlushColumn();
+
+			std::vector<uint8_t> m_codes;
+			std::vector<Point> m_points;
+			std::vector<std::size_t> m_runEnds;
+			std::size_t m_runStart = 0;
+			bool m_runOpen = false;
+			Column m_column;
+			bool m_columnOpen = false;
+	};
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef SDL2PP_PROFILER
+#define SDL2PP_PROFILER
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace SDL{
+
+	// Per-frame timing of the wrapper. Zones are recorded through the
+	// SDL2PP_PROFILE_* macros below, which compile to nothing unless the
+	// project is configured with SDL2PP_PROFILE. The profiler keeps the last
+	// HistoryLength frames for histograms and can capture a Chrome trace
+	// (chrome://tracing, Perfetto).
+	//
+	// Not thread-safe; record only from the thread driving the renderer.
+	class Profiler{
+		public:
+			enum class Zone : uint8_t{
+				Frame,
+				RenderPresent,
+				EventDispatch,
+				RenderClear,
+				RenderDrawPoint,
+				RenderDrawPoints,
+				RenderDrawLine,
+				RenderDrawLines,
+				RenderDrawRect,
+				RenderDrawRects,
+				RenderFillRect,
+				RenderFillRects,
+				RenderCopy,
+				RenderReadPixels,
+				SetRenderDrawColor,
+				SetRenderState,
+				FlushCommandBuffer,
+				SubmitCommandLists,
+				CreateTexture,
+				UpdateTexture,
+				LockTexture,
+				DecodeImage,
+				ReducePolyline,
+				Count
+			};
+
+			struct ZoneStats{
+				uint32_t calls = 0;
+				uint64_t ticks = 0;
+			};
+
+			static const std::size_t HistoryLength = 240;
+
+			static Profiler& Get();
+			static const char* GetZoneName(Zone zone);
+
+			static uint64_t Now();
+			double ToMilliseconds(uint64_t ticks) const;
+
+			void Record(Zone zone, uint64_t begin, uint64_t end);
+			// Closes the current frame; called by Renderer::RenderPresent().
+			void EndFrame();
+
+			const ZoneStats& GetLastFrame(Zone zone) const;
+			std::size_t GetHistorySize() const;
+			// Counts of frames per bucketMs wide bucket of the zone's time per
+			// frame; the last bucket also holds everything above.
+			std::vector<uint32_t> GetHistogram(Zone zone, double bucketMs, std::size_t bucketCount) const;
+			double GetPercentile(Zone zone, double percentile) const;
+
+			void StartTrace(std::size_t maxEvents);
+			void StopTrace();
+			void WriteChromeTrace(std::ostream& stream) const;
+			bool WriteChromeTrace(const std::string& path) const;
+
+		private:
+			typedef std::array<ZoneStats, static_cast<std::size_t>(Zone::Count)> FrameStats;
+
+			struct TraceEvent{
+				Zone zone;
+				uint64_t begin;
+				uint64_t end;
+			};
+
+			Profiler();
+
+			uint64_t m_frequency;
+			uint64_t m_frameBegin;
+			FrameStats m_current{};
+			std::array<FrameStats, HistoryLength> m_history{};
+			std::size_t m_frames = 0;
+
+			bool m_tracing = false;
+			std::size_t m_maxEvents = 0;
+			std::vector<TraceEvent> m_events;
+	};
+
+	class ProfileScope{
+		public:
+			ProfileScope(Profiler::Zone zone):m_zone(zone), m_begin(Profiler::Now()){}
+			~ProfileScope(){ Profiler::Get().Record(m_zone, m_begin, Profiler::Now()); }
+
+			ProfileScope(const ProfileScope&) = delete;
+			ProfileScope& operator=(const ProfileScope&) = delete;
+
+		private:
+			Profiler::Zone m_zone;
+			uint64_t m_begin;
+	};
+
+}
+
+#define SDL2PP_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SDL2PP_PROFILE_CONCAT(a, b) SDL2PP_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SDL2PP_PROFILE
+#define SDL2PP_PROFILE_ZONE(zone) ::SDL::ProfileScope SDL2PP_PROFILE_CONCAT(profileScope, __LINE__)(::SDL::Profiler::Zone::zone)
+#define SDL2PP_PROFILE_END_FRAME() ::SDL::Profiler::Get().EndFrame()
+#else
+#define SDL2PP_PROFILE_ZONE(zone) ((void)0)
+#define SDL2PP_PROFILE_END_FRAME() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SDL2PP_RASTERIZER
+#define SDL2PP_RASTERIZER
+
+#include <cstddef>
+#include <cstdint>
+#include <SDL_blendmode.h>
+#include <SDL_rect.h>
+#include "point.h"
+#include "rect.h"
+
+class SDL_Surface;
+
+namespace SDL{
+
+	// Draws points, lines, rects and fills straight into a 32-bit surface
+	// with the same pixels SDL's software renderer produces: same Bresenham
+	// steps, same clipping and the same integer blend formulas. Spans are
+	// written with SSE2 or, where the CPU has it, AVX2 kernels.
+	//
+	// Coordinates are relative to the viewport; the clip rect is relative to
+	// the viewport as well, like SDL_RenderSetClipRect().
+	class SurfaceRasterizer{
+		public:
+			// 32 bits per pixel with 8-bit channels, alpha optional.
+			static bool Supports(const SDL_Surface* surface);
+			// Blend modes with a kernel; others have to go through SDL.
+			static bool SupportsBlendMode(SDL_BlendMode blendMode);
+			// Whether DrawLines() matches the linked SDL's lines, which depend
+			// on its version and line method. Read when a renderer is created.
+			static bool SupportsLines();
+			// "avx2", "sse2" or "scalar".
+			static const char* GetKernelName();
+
+			SurfaceRasterizer(SDL_Surface* surface);
+
+			void SetDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+			void SetBlendMode(SDL_BlendMode blendMode);
+			SDL_BlendMode GetBlendMode() const{ return m_blendMode; }
+			// nullptr selects the whole surface.
+			void SetViewport(const Rect* rect);
+			// nullptr disables clipping.
+			void SetClipRect(const Rect* rect);
+			// Limits all drawing, Clear() included, to a rect in surface
+			// coordinates, e.g. one tile. nullptr selects the whole surface.
+			void SetBounds(const Rect* rect);
+
+			const Rect& GetViewport() const{ return m_viewport; }
+			// Drawable area in surface coordinates: viewport, clip rect and
+			// bounds combined.
+			const Rect& GetVisibleRect() const{ return m_clip; }
+
+			// Drawing calls return 0, or -1 if the surface could not be locked.
+			// Clear() fills the whole surface, or the bounds, ignoring
+			// viewport, clip rect and blend mode.
+			int Clear();
+			int DrawPoints(const Point* points, std::size_t count);
+			int DrawLines(const Point* points, std::size_t count);
+			// Only segments [firstSegment, firstSegment + segmentCount) of the
+			// polyline, drawn exactly as DrawLines() would draw them.
+			int DrawLines(const Point* points, std::size_t count, std::size_t firstSegment, std::size_t segmentCount);
+			int DrawRects(const Rect* rects, std::size_t count);
+			int FillRects(const Rect* rects, std::size_t count);
+
+		private:
+			// Per byte of a pixel: out = min(in * mul / 255 + add, 255).
+			struct BlendOp{
+				uint8_t mul[4];
+				uint8_t add[4];
+			};
+
+			void UpdateColor();
+			void UpdateClip();
+			void DrawPolyline(const Point* points, std::size_t count, std::size_t firstSegment, std::size_t segmentCount);
+			void DrawLine(int x1, int y1, int x2, int y2, bool drawLast);
+			// Viewport coordinates, clipped here.
+			void DrawPixel(int x, int y);
+			// Surface coordinates, already clipped.
+			void DrawSpan(int x, int y, int length);
+			uint32_t* Row(int y) const;
+
+			SDL_Surface* m_surface;
+			uint8_t m_color[4] = {255, 255, 255, 255};
+			SDL_BlendMode m_blendMode = SDL_BLENDMODE_NONE;
+			uint32_t m_pixel = 0;
+			BlendOp m_op{};
+			Rect m_viewport{0, 0, 0, 0};
+			Rect m_clipRect{0, 0, 0, 0};
+			bool m_clipEnabled = false;
+			Rect m_bounds{0, 0, 0, 0};
+			// Visible area in surface coordinates.
+			Rect m_clip{0, 0, 0, 0};
+	};
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef SDL2PP_READBACK
+#define SDL2PP_READBACK
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "rect.h"
+
+namespace SDL{
+
+	class Renderer;
+
+	// Captures frames into a ring of preallocated buffers and hands them to
+	// a worker thread, which converts them to the output format and passes
+	// them to the consumer, e.g. an encoder or a screenshot writer.
+	//
+	// Capture() costs the render thread one SDL_RenderReadPixels in the read
+	// format plus a lock; it never allocates and never waits for the worker.
+	// If the worker falls behind and every buffer is in use, the frame is
+	// dropped and counted.
+	class FrameReadback{
+		public:
+			struct Frame{
+				const uint8_t* pixels;
+				int width;
+				int height;
+				int pitch;
+				uint32_t format;
+				// Capture() calls since construction, dropped ones included.
+				uint64_t index;
+				// SDL_GetTicks() at capture.
+				uint32_t timestamp;
+			};
+
+			// Runs on the worker thread. The pixels are only valid during the
+			// call.
+			typedef std::function<void(const Frame& frame)> Consumer;
+
+			// Reading in the target's own format keeps conversion off the
+			// render thread; outputFormat == readFormat skips the conversion.
+			FrameReadback(int width, int height, uint32_t readFormat, uint32_t outputFormat, std::size_t bufferCount, Consumer consumer);
+			// Processes the queued frames before returning.
+			~FrameReadback();
+
+			FrameReadback(const FrameReadback&) = delete;
+			FrameReadback& operator=(const FrameReadback&) = delete;
+
+			// Reads the top left width x height pixels of the current target,
+			// or rect, which must have that size. Call before RenderPresent().
+			// Returns false if the frame was dropped or reading failed.
+			bool Capture(Renderer& renderer);
+			bool Capture(Renderer& renderer, const Rect& rect);
+
+			// Waits until the worker has processed every captured frame and
+			// rethrows the first exception the consumer threw since the last
+			// Flush(). A frame that fails to convert is not passed on; the
+			// failure is rethrown here as an Error.
+			void Flush();
+
+			uint64_t GetCapturedCount() const;
+			uint64_t GetDroppedCount() const;
+
+		private:
+			struct Buffer{
+				std::vector<uint8_t> pixels;
+				uint64_t index = 0;
+				uint32_t timestamp = 0;
+			};
+
+			void Work();
+
+			int m_width;
+			int m_height;
+			uint32_t m_readFormat;
+			uint32_t m_outputFormat;
+			int m_readPitch;
+			int m_outputPitch;
+			Consumer m_consumer;
+
+			std::vector<Buffer> m_buffers;
+			// Output of the conversion, only touched by the worker.
+			std::vector<uint8_t> m_converted;
+
+			mutable std::mutex m_mutex;
+			std::condition_variable m_ready;
+			std::condition_variable m_idle;
+			// Buffers [m_consumed, m_written) modulo the ring size hold frames
+			// for the worker; m_consumed advances once the consumer is done.
+			uint64_t m_written = 0;
+			uint64_t m_consumed = 0;
+			bool m_stop = false;
+			uint64_t m_frames = 0;
+			uint64_t m_dropped = 0;
+			std::exception_ptr m_error;
+
+			std::thread m_worker;
+	};
+
+}
+
+#endif
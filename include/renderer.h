@@ -1,16 +1,59 @@
 #ifndef SDL2PP_RENDERER
 #define SDL2PP_RENDERER
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <new>
 #include <vector>
 #include <glm/glm.hpp>
+#include <SDL_blendmode.h>
+#include <SDL_rect.h>
+#include <SDL_render.h>
 #include "point.h"
 #include "rect.h"
+#include "result.h"
+#include "span.h"
 
 class SDL_Renderer;
+class SDL_Surface;
 
 namespace SDL{
 
+	class RenderCommandBuffer;
+	class SurfaceRasterizer;
+	class Texture;
+	class TiledRasterizer;
+	class TexturePool;
+
+	// Number of SDL state calls issued and skipped as no-ops during a frame.
+	struct RenderStateStats{
+		struct Counter{
+			uint32_t issued = 0;
+			uint32_t elided = 0;
+		};
+
+		Counter drawColor;
+		Counter blendMode;
+		Counter viewport;
+		Counter clipRect;
+		Counter scale;
+		Counter target;
+
+		uint32_t Issued() const{ return drawColor.issued + blendMode.issued + viewport.issued + clipRect.issued + scale.issued + target.issued; }
+		uint32_t Elided() const{ return drawColor.elided + blendMode.elided + viewport.elided + clipRect.elided + scale.elided + target.elided; }
+	};
+
+	// How a software renderer draws primitives into its surface. Tiled
+	// records into the command buffer and draws points, lines, rects and
+	// fills on all cores with SIMD kernels, one screen tile per task, and
+	// hands everything else to SDL. It needs a 32-bit surface that does not
+	// need locking; with any other surface SDL is used.
+	enum class SoftwareBackend : uint8_t{
+		SDL,
+		Tiled
+	};
+
 	class Renderer{
 		public:
 			Renderer();
@@ -19,20 +62,32 @@ namespace SDL{
 
 			void DestroyRenderer();
 
+			// Renderer drawing into a memory surface, which has to outlive it.
+			static std::shared_ptr<Renderer> CreateSoftwareRenderer(SDL_Surface* surface, SoftwareBackend backend = SoftwareBackend::SDL);
+			SoftwareBackend GetSoftwareBackend() const;
+
+			static int GetNumRenderDrivers();
 
-			static auto GetNumRenderDrivers();
+			static SDL_RendererInfo GetRenderDriverInfo(int index);
 
-			static auto GetRenderDriverInfo(int index);
+			SDL_RendererInfo GetRendererInfo();
 
-			auto GetRendererInfo();
+			glm::ivec2 GetRendererOutputSize();
 
-			auto GetRendererOutputSize();
+			std::shared_ptr<Texture> CreateTexture(uint32_t format, int access, int w, int h);
 
-			auto CreateTexture(uint32_t format, int access, int w, int h);
+			// With a pool set, CreateTexture() hands out recycled textures and
+			// released textures go back to the pool instead of being destroyed.
+			void SetTexturePool(std::shared_ptr<TexturePool> pool);
+			std::shared_ptr<TexturePool> GetTexturePool() const{ return m_texturePool; }
 
-			auto RenderTargetSupported();
+			bool RenderTargetSupported();
 
+			// Calls taking std::nothrow return the SDL result instead of
+			// throwing. Failures are also collected per frame, so a loop can
+			// ignore the results and check GetFrameErrors() once.
 			void RenderClear();
+			Result RenderClear(const std::nothrow_t&);
 
 			void RenderDrawPoint(glm::ivec2 p);
 			void RenderDrawPoint(glm::ivec2& p);
@@ -40,8 +95,12 @@ namespace SDL{
 			void RenderDrawPoint(Point& p);
 
 			void RenderDrawPoint(int x, int y);
+			Result RenderDrawPoint(int x, int y, const std::nothrow_t&);
 
 			void RenderDrawPoints(std::vector<Point>& points);
+			void RenderDrawPoints(Span<const Point> points);
+			Result RenderDrawPoints(Span<const Point> points, const std::nothrow_t&);
+			void RenderDrawPoints(Span<const glm::ivec2> points);
 
 			void RenderDrawLine(glm::ivec2 p1, glm::ivec2 p2);
 			void RenderDrawLine(glm::ivec2& p1, glm::ivec2& p2);
@@ -49,88 +108,170 @@ namespace SDL{
 			void RenderDrawLine(Point& p1, Point& p2);
 
 			void RenderDrawLine(int x1, int y1, int x2, int y2);
+			Result RenderDrawLine(int x1, int y1, int x2, int y2, const std::nothrow_t&);
 
 			void RenderDrawLines(std::vector<Point>& points);
+			void RenderDrawLines(Span<const Point> points);
+			Result RenderDrawLines(Span<const Point> points, const std::nothrow_t&);
+			void RenderDrawLines(Span<const glm::ivec2> points);
 
 			void RenderDrawRect(Rect& rect);
+			Result RenderDrawRect(const Rect& rect, const std::nothrow_t&);
 
 			void RenderDrawRects(std::vector<Rect>& rects);
+			void RenderDrawRects(Span<const Rect> rects);
+			Result RenderDrawRects(Span<const Rect> rects, const std::nothrow_t&);
 
 			void RenderFillRect(Rect& rect);
+			Result RenderFillRect(const Rect& rect, const std::nothrow_t&);
 
 			void RenderFillRects(std::vector<Rect>& rects);
+			void RenderFillRects(Span<const Rect> rects);
+			Result RenderFillRects(Span<const Rect> rects, const std::nothrow_t&);
+
+			void RenderCopy(Texture& texture);
+			void RenderCopy(Texture& texture, const Rect& srcRect, const Rect& dstRect);
+			Result RenderCopy(Texture& texture, const Rect& srcRect, const Rect& dstRect, const std::nothrow_t&);
+			// Copies several regions of one texture, e.g. sprites sharing an
+			// atlas page, without switching textures in between.
+			void RenderCopies(Texture& texture, Span<const Rect> srcRects, Span<const Rect> dstRects);
+			// Rotated by angle degrees clockwise around center, the middle of
+			// dstRect if nullptr. Not recorded; flushes the command buffer.
+			void RenderCopyEx(Texture& texture, const Rect& srcRect, const Rect& dstRect, double angle, const Point* center, SDL_RendererFlip flip);
+			Result RenderCopyEx(Texture& texture, const Rect& srcRect, const Rect& dstRect, double angle, const Point* center, SDL_RendererFlip flip, const std::nothrow_t&);
 			void RenderPresent();
+			// Presents even if flushing failed and returns the first failure.
+			Result RenderPresent(const std::nothrow_t&);
+			// Reads back the current target, rect == nullptr for all of it, after
+			// flushing the command buffer. Call it before RenderPresent(), which
+			// leaves the back buffer undefined, and after SubmitCommandLists()
+			// if the lists should be included. Format 0 is the target's format.
+			void RenderReadPixels(const Rect* rect, uint32_t format, void* pixels, int pitch);
+			Result RenderReadPixels(const Rect* rect, uint32_t format, void* pixels, int pitch, const std::nothrow_t&);
 			void SetRenderDrawColor(glm::i8vec4 color);
 			void SetRenderDrawColor(glm::i8vec4& color);
 			void SetRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+			Result SetRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a, const std::nothrow_t&);
+			glm::i8vec4 GetRenderDrawColor();
+			Result GetRenderDrawColor(glm::i8vec4& color, const std::nothrow_t&);
+
+			void SetRenderDrawBlendMode(SDL_BlendMode blendMode);
+			SDL_BlendMode GetRenderDrawBlendMode();
+
+			void RenderSetViewport(const Rect& rect);
+			void RenderSetViewport();
+			Rect RenderGetViewport();
+
+			void RenderSetClipRect(const Rect& rect);
+			void RenderSetClipRect();
+			Rect RenderGetClipRect();
+			bool RenderIsClipEnabled();
+			// What drawing can reach, in draw coordinates: the viewport's size
+			// limited by the clip rect. Empty if nothing is visible.
+			Rect RenderGetVisibleRect();
+
+			void RenderSetScale(float scaleX, float scaleY);
+			glm::vec2 RenderGetScale();
+
+			void SetRenderTarget(std::shared_ptr<Texture> texture);
+			std::shared_ptr<Texture> GetRenderTarget() const{ return m_target; }
+
+			// State setters skip the SDL call when the cached value already
+			// matches. Call this after changing renderer state through the C API.
+			void InvalidateRenderState();
+			// Counters of the last presented frame.
+			const RenderStateStats& GetRenderStateStats() const{ return m_lastStateStats; }
+			// Failed non-throwing calls of the current and the last presented frame.
+			const ErrorAccumulator& GetFrameErrors() const{ return m_frameErrors; }
+			const ErrorAccumulator& GetLastFrameErrors() const{ return m_lastFrameErrors; }
+
+			// While enabled, draw color changes, clears and primitives are
+			// recorded and only submitted on FlushCommandBuffer() or
+			// RenderPresent(). Errors are reported when flushing.
+			void EnableCommandBuffer(bool enable);
+			bool IsCommandBufferEnabled() const{ return m_commandBuffer != nullptr; }
+			void FlushCommandBuffer();
+			Result FlushCommandBuffer(const std::nothrow_t&);
+
+			// Command lists for recording on worker threads. Every slot has its
+			// own arena, so threads filling different slots never synchronize.
+			// All recording must be finished before RenderPresent(), which
+			// submits the lists after the renderer's own commands in slot order.
+			// Every list starts out, and again after each submission, with
+			// opaque black as its draw color, not the renderer's; set the color
+			// before drawing. Only the thread owning the renderer may change
+			// the list count.
+			void SetCommandListCount(std::size_t count);
+			std::size_t GetCommandListCount() const{ return m_commandLists.size(); }
+			RenderCommandBuffer& GetCommandList(std::size_t slot);
+			void SubmitCommandLists();
+			Result SubmitCommandLists(const std::nothrow_t&);
 
 
 		private:
+			struct RenderState{
+				bool drawColorKnown = false;
+				bool blendModeKnown = false;
+				bool viewportKnown = false;
+				bool clipRectKnown = false;
+				bool scaleKnown = false;
+				bool targetKnown = false;
+
+				uint8_t drawColor[4] = {0, 0, 0, 0};
+				SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+				Rect viewport{0, 0, 0, 0};
+				bool viewportSet = false;
+				Rect clipRect{0, 0, 0, 0};
+				bool clipEnabled = false;
+				glm::vec2 scale{1.0f, 1.0f};
+			};
+
+			int ApplyRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a);
+			int SubmitCommandBuffer(RenderCommandBuffer& buffer);
+			int SubmitCopy(const RenderCommandBuffer& buffer, std::size_t command);
+			int SubmitTiled(RenderCommandBuffer& buffer);
+			// Records a failure in the frame's error accumulator.
+			Result Check(int code);
+
+			// Draw through the rasterizer when it matches SDL's state, else
+			// through SDL.
+			int DispatchClear();
+			int DispatchPoints(const Point* points, std::size_t count);
+			int DispatchLines(const Point* points, std::size_t count);
+			int DispatchRects(const Rect* rects, std::size_t count);
+			int DispatchFillRects(const Rect* rects, std::size_t count);
+			// Makes SDL execute its queued commands before the rasterizer
+			// writes to the same surface.
+			int FlushSDL();
+			void SyncRasterizer();
+			void EndFrame();
+
 			SDL_Renderer* m_renderer = nullptr;
+			std::unique_ptr<RenderCommandBuffer> m_commandBuffer;
+			std::vector<std::unique_ptr<RenderCommandBuffer>> m_commandLists;
+			std::shared_ptr<Texture> m_target;
+			std::shared_ptr<TexturePool> m_texturePool;
+			std::unique_ptr<SurfaceRasterizer> m_rasterizer;
+			std::unique_ptr<TiledRasterizer> m_tiled;
+			bool m_rasterizerActive = false;
+			// Lines go to SDL where the rasterizer would draw them differently.
+			bool m_rasterizerLines = false;
+			bool m_sdlPending = false;
+			RenderState m_state;
+			RenderStateStats m_stateStats;
+			RenderStateStats m_lastStateStats;
+			ErrorAccumulator m_frameErrors;
+			ErrorAccumulator m_lastFrameErrors;
 
 
 
-			// static SDL_Renderer * SDL_CreateSoftwareRenderer(SDL_Surface * surface);
-			// 
-			// 
 			// extern DECLSPEC SDL_Texture * SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface);
 			// 
-			// extern DECLSPEC int SDL_SetRenderTarget(SDL_Renderer *renderer,
-			//                                                 SDL_Texture *texture);
-			// 
-			// extern DECLSPEC SDL_Texture * SDL_GetRenderTarget(SDL_Renderer *renderer);
-			// 
 			// extern DECLSPEC int SDL_RenderSetLogicalSize(SDL_Renderer * renderer, int w, int h);
 			// 
 			// extern DECLSPEC void SDL_RenderGetLogicalSize(SDL_Renderer * renderer, int *w, int *h);
 			// 
-			// extern DECLSPEC int SDL_RenderSetViewport(SDL_Renderer * renderer,
-			//                                                   const SDL_Rect * rect);
-			// 
-			// extern DECLSPEC void SDL_RenderGetViewport(SDL_Renderer * renderer,
-			//                                                    SDL_Rect * rect);
-			// 
-			// extern DECLSPEC int SDL_RenderSetClipRect(SDL_Renderer * renderer,
-			//                                                   const SDL_Rect * rect);
-			// 
-			// extern DECLSPEC void SDL_RenderGetClipRect(SDL_Renderer * renderer,
-			//                                                    SDL_Rect * rect);
-			// 
-			// extern DECLSPEC int SDL_RenderSetScale(SDL_Renderer * renderer,
-			//                                                float scaleX, float scaleY);
-			// 
-			// extern DECLSPEC void SDL_RenderGetScale(SDL_Renderer * renderer,
-			//                                                float *scaleX, float *scaleY);
-			// 
-			// extern DECLSPEC int SDL_GetRenderDrawColor(SDL_Renderer * renderer,
-			//                                            uint8_t * r, uint8_t * g, uint8_t * b,
-			//                                            uint8_t * a);
-			// 
-			// extern DECLSPEC int SDL_SetRenderDrawBlendMode(SDL_Renderer * renderer,
-			//                                                        SDL_BlendMode blendMode);
-			// 
-			// extern DECLSPEC int SDL_GetRenderDrawBlendMode(SDL_Renderer * renderer,
-			//                                                        SDL_BlendMode *blendMode);
-			// 
 
-			// extern DECLSPEC int SDL_RenderCopy(SDL_Renderer * renderer,
-			//                                            SDL_Texture * texture,
-			//                                            const SDL_Rect * srcrect,
-			//                                            const SDL_Rect * dstrect);
-			// 
-			// extern DECLSPEC int SDL_RenderCopyEx(SDL_Renderer * renderer,
-			//                                            SDL_Texture * texture,
-			//                                            const SDL_Rect * srcrect,
-			//                                            const SDL_Rect * dstrect,
-			//                                            const double angle,
-			//                                            const SDL_Point *center,
-			//                                            const SDL_RendererFlip flip);
-			// 
-			// extern DECLSPEC int SDL_RenderReadPixels(SDL_Renderer * renderer,
-			//                                                  const SDL_Rect * rect,
-			//                                                  uint32_t format,
-			//                                                  void *pixels, int pitch);
-			// 
 
 
 
@@ -0,0 +1,58 @@
+#ifndef SDL2PP_RESULT
+#define SDL2PP_RESULT
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace SDL{
+
+	// Outcome of a non-throwing call: the SDL return code. The message is
+	// only fetched on request and is SDL's last error of the calling thread,
+	// so ask for it before making further SDL calls.
+	class Result{
+		public:
+			Result():m_code(0){}
+			explicit Result(int code):m_code(code){}
+
+			bool Ok() const{ return m_code == 0; }
+			explicit operator bool() const{ return m_code == 0; }
+			int GetCode() const{ return m_code; }
+
+			std::string GetMessage() const;
+			void ThrowIfFailed() const;
+
+		private:
+			int m_code;
+	};
+
+	// Collects failures of non-throwing calls so that a hot loop can check
+	// once per frame. Only the first failure's code and message are kept; the
+	// message is copied into a fixed buffer, recording never allocates.
+	class ErrorAccumulator{
+		public:
+			void Record(const Result& result){
+				if(!result.Ok())
+					RecordFailure(result.GetCode());
+			}
+
+			bool Ok() const{ return m_failures == 0; }
+			uint32_t GetFailureCount() const{ return m_failures; }
+			int GetFirstCode() const{ return m_firstCode; }
+			const char* GetFirstMessage() const{ return m_firstMessage.data(); }
+
+			void Reset();
+			// Throws an SDL::Error carrying the first recorded message.
+			void ThrowIfFailed() const;
+
+		private:
+			void RecordFailure(int code);
+
+			uint32_t m_failures = 0;
+			int m_firstCode = 0;
+			std::array<char, 256> m_firstMessage{};
+	};
+
+}
+
+#endif
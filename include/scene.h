@@ -0,0 +1,64 @@
+#ifndef SDL2PP_SCENE
+#define SDL2PP_SCENE
+
+#include <cstddef>
+#include <vector>
+#include <SDL_blendmode.h>
+#include <SDL_rect.h>
+#include "point.h"
+#include "rect.h"
+#include "spatialgrid.h"
+
+namespace SDL{
+
+	class Renderer;
+	class SpriteBatch;
+	class Texture;
+
+	// Retained sprites on a canvas larger than the screen. Each frame only
+	// the sprites intersecting the visible part are looked up in a
+	// SpatialGrid and queued on a SpriteBatch; offscreen sprites cost nothing
+	// per frame. Textures are referenced and must outlive their sprites.
+	class Scene{
+		public:
+			typedef SpatialGrid::Handle Handle;
+
+			struct Sprite{
+				Texture* texture;
+				Rect srcRect;
+				// Where the sprite is drawn, in canvas coordinates.
+				Rect bounds;
+				int layer;
+				SDL_BlendMode blendMode;
+			};
+
+			Scene(const Rect& world, int cellSize = 256);
+
+			Handle AddSprite(Texture& texture, const Rect& srcRect, const Rect& bounds, int layer = 0, SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+			void MoveSprite(Handle handle, const Rect& bounds);
+			void RemoveSprite(Handle handle);
+			void Clear();
+
+			const Sprite& GetSprite(Handle handle) const;
+			std::size_t GetSize() const{ return m_grid.GetSize(); }
+			const SpatialGrid& GetIndex() const{ return m_grid; }
+
+			// Queues the sprites inside view, a canvas rect whose corner is
+			// drawn at the origin. Returns how many were queued.
+			std::size_t Draw(SpriteBatch& batch, const Rect& view);
+			// Culls against the renderer's visible rect with camera, in canvas
+			// coordinates, at its origin and flushes the batch.
+			std::size_t Draw(Renderer& renderer, SpriteBatch& batch, Point camera);
+
+		private:
+			// Queues the sprites inside view, drawn relative to origin.
+			std::size_t Queue(SpriteBatch& batch, const Rect& view, Point origin);
+
+			SpatialGrid m_grid;
+			std::vector<Sprite> m_sprites;
+			std::vector<Handle> m_visible;
+	};
+
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef SDL2PP_SPAN
+#define SDL2PP_SPAN
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace SDL{
+
+	// Non-owning view of contiguous elements, used by the batch draw calls so
+	// callers can hand over data from any buffer without copying it.
+	template<typename T>
+	class Span{
+		public:
+			typedef T element_type;
+			typedef std::remove_const_t<T> value_type;
+
+			Span():m_data(nullptr), m_size(0){}
+			Span(T* data, std::size_t size):m_data(data), m_size(size){}
+			Span(T* first, T* last):m_data(first), m_size(last - first){}
+
+			template<std::size_t N>
+			Span(T (&array)[N]):m_data(array), m_size(N){}
+
+			template<std::size_t N>
+			Span(std::array<value_type, N>& array):m_data(array.data()), m_size(N){}
+
+			template<std::size_t N, typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+			Span(const std::array<value_type, N>& array):m_data(array.data()), m_size(N){}
+
+			Span(std::vector<value_type>& vector):m_data(vector.data()), m_size(vector.size()){}
+
+			template<typename U = T, typename = std::enable_if_t<std::is_const<U>::value>>
+			Span(const std::vector<value_type>& vector):m_data(vector.data()), m_size(vector.size()){}
+
+			template<typename U, typename = std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>::value>>
+			Span(const Span<U>& other):m_data(other.data()), m_size(other.size()){}
+
+			T* data() const{ return m_data; }
+			std::size_t size() const{ return m_size; }
+			bool empty() const{ return m_size == 0; }
+
+			T* begin() const{ return m_data; }
+			T* end() const{ return m_data + m_size; }
+
+			T& operator[](std::size_t index) const{ return m_data[index]; }
+
+			Span subspan(std::size_t offset, std::size_t count) const{ return Span(m_data + offset, count); }
+
+		private:
+			T* m_data;
+			std::size_t m_size;
+	};
+
+}
+
+#endif
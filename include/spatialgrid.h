@@ -0,0 +1,75 @@
+#ifndef SDL2PP_SPATIALGRID
+#define SDL2PP_SPATIALGRID
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SDL_rect.h>
+#include "rect.h"
+
+namespace SDL{
+
+	// Uniform grid over the bounds of many objects, answering which of them
+	// intersect a rect, e.g. the visible part of a large canvas, without
+	// looking at the others. Objects outside the world rect are kept in the
+	// border cells, so they are still found, only less efficiently.
+	class SpatialGrid{
+		public:
+			typedef uint32_t Handle;
+			static const Handle InvalidHandle = 0xFFFFFFFFu;
+
+			// cellSize should be around the size of a typical object or a
+			// fraction of the typical query.
+			SpatialGrid(const Rect& world, int cellSize);
+
+			Handle Insert(const Rect& bounds);
+			// Cheap if the object stays within the same cells.
+			void Move(Handle handle, const Rect& bounds);
+			void Remove(Handle handle);
+			void Clear();
+
+			const Rect& GetBounds(Handle handle) const;
+			std::size_t GetSize() const{ return m_size; }
+
+			// Appends the objects intersecting rect in ascending handle order.
+			void Query(const Rect& rect, std::vector<Handle>& result) const;
+
+		private:
+			struct CellRange{
+				int x0;
+				int y0;
+				int x1;
+				int y1;
+
+				bool operator==(const CellRange& other) const{
+					return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+				}
+			};
+
+			struct Entry{
+				Rect bounds;
+				CellRange cells;
+				bool live;
+			};
+
+			CellRange GetCells(const Rect& bounds) const;
+			void AddToCells(Handle handle, const CellRange& cells);
+			void RemoveFromCells(Handle handle, const CellRange& cells);
+			const Entry& GetEntry(Handle handle) const;
+
+			Rect m_world;
+			int m_cellSize;
+			int m_cellsX;
+			int m_cellsY;
+			std::vector<std::vector<Handle>> m_cells;
+			std::vector<Entry> m_entries;
+			std::vector<Handle> m_freeHandles;
+			std::size_t m_size = 0;
+			// Marks entries already reported by the running query.
+			mutable std::vector<uint32_t> m_queryMarks;
+			mutable uint32_t m_queryStamp = 0;
+	};
+
+}
+
+#endif
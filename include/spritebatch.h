@@ -0,0 +1,89 @@
+#ifndef SDL2PP_SPRITEBATCH
+#define SDL2PP_SPRITEBATCH
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <SDL_blendmode.h>
+#include <SDL_rect.h>
+#include <SDL_render.h>
+#include "rect.h"
+
+namespace SDL{
+
+	class Renderer;
+	class Texture;
+
+	// Collects the sprites of a frame and draws them with as few texture and
+	// blend mode switches as possible. Layers are drawn in ascending order;
+	// inside a layer sprites are grouped by texture, then blend mode, and
+	// keep their submission order within a group. Sprites of one layer that
+	// overlap with different textures may therefore be reordered.
+	//
+	// Textures are referenced, not owned, and must stay alive until Flush().
+	class SpriteBatch{
+		public:
+			struct Stats{
+				std::size_t sprites = 0;
+				// RenderCopies() and RenderCopyEx() calls.
+				std::size_t batches = 0;
+				std::size_t textureSwitches = 0;
+				std::size_t blendModeChanges = 0;
+			};
+
+			SpriteBatch(Renderer& renderer);
+
+			void Draw(Texture& texture, const Rect& srcRect, const Rect& dstRect, int layer = 0, SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+			// Rotated around the center of dstRect; drawn one by one.
+			void Draw(Texture& texture, const Rect& srcRect, const Rect& dstRect, float angle, SDL_RendererFlip flip, int layer = 0, SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+
+			// Submits and clears the batch. Leaves each texture set to the
+			// blend mode of its last sprite.
+			void Flush();
+			void Clear();
+
+			std::size_t GetSize() const{ return m_textureIds.size(); }
+			const Stats& GetLastStats() const{ return m_lastStats; }
+
+		private:
+			struct SortEntry{
+				uint64_t key;
+				uint32_t index;
+
+				bool operator<(const SortEntry& other) const{
+					return key < other.key || (key == other.key && index < other.index);
+				}
+			};
+
+			uint32_t GetTextureId(Texture& texture);
+			uint8_t GetBlendId(SDL_BlendMode blendMode);
+			bool IsTransformed(uint32_t index) const{ return m_angles[index] != 0.0f || m_flips[index] != SDL_FLIP_NONE; }
+
+			Renderer& m_renderer;
+
+			// One entry per sprite; the sort only moves keys and indices.
+			std::vector<int32_t> m_layers;
+			std::vector<uint32_t> m_textureIds;
+			std::vector<uint8_t> m_blendIds;
+			std::vector<Rect> m_srcRects;
+			std::vector<Rect> m_dstRects;
+			std::vector<float> m_angles;
+			std::vector<uint8_t> m_flips;
+
+			// Ids are handed out per frame in order of first use.
+			std::vector<Texture*> m_textures;
+			std::unordered_map<Texture*, uint32_t> m_textureLookup;
+			Texture* m_lastTexture = nullptr;
+			uint32_t m_lastTextureId = 0;
+			std::vector<SDL_BlendMode> m_blendModes;
+
+			std::vector<SortEntry> m_order;
+			std::vector<Rect> m_runSrcRects;
+			std::vector<Rect> m_runDstRects;
+			Stats m_lastStats;
+	};
+
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SDL2PP_STREAMINGTEXTURE
+#define SDL2PP_STREAMINGTEXTURE
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "dirtyrects.h"
+#include "rect.h"
+
+namespace SDL{
+
+	class Renderer;
+	class Texture;
+
+	// Streaming texture fed from a CPU-side pixel buffer. Writers mark the
+	// regions they changed, Upload() copies only those regions into the
+	// texture through LockTexture.
+	//
+	// In double-buffered mode two textures alternate: Upload() fills the one
+	// that is not being displayed and swaps, so writing frame N+1 never waits
+	// for frame N. Each texture remembers what it missed while it was in
+	// front, so both stay in sync with the pixel buffer.
+	class StreamingTexture{
+		public:
+			StreamingTexture(Renderer& renderer, uint32_t format, int w, int h, bool doubleBuffered = false);
+			~StreamingTexture();
+
+			void* GetPixels(){ return m_pixels.data(); }
+			int GetPitch() const{ return m_pitch; }
+			uint8_t* GetRow(int y){ return m_pixels.data() + y * m_pitch; }
+			int GetWidth() const{ return m_width; }
+			int GetHeight() const{ return m_height; }
+
+			void MarkDirty(const Rect& rect);
+			void MarkDirty();
+
+			// Uploads pending changes and returns the texture to draw.
+			std::shared_ptr<Texture> Upload();
+			std::shared_ptr<Texture> GetTexture() const{ return m_textures[m_front]; }
+
+		private:
+			void Upload(Texture& texture, const DirtyRects& dirty);
+
+			int m_width;
+			int m_height;
+			int m_bytesPerPixel;
+			int m_pitch;
+			std::vector<uint8_t> m_pixels;
+			std::vector<std::shared_ptr<Texture>> m_textures;
+			std::vector<DirtyRects> m_dirty;
+			std::size_t m_front = 0;
+	};
+
+}
+
+#endif
@@ -1,7 +1,10 @@
 #ifndef SDL2PP_TEXTUE
 #define SDL2PP_TEXTUE
 
+#include <cstdint>
+#include <SDL_blendmode.h>
 #include <SDL_rect.h>
+#include "rect.h"
 
 class SDL_Texture;
 
@@ -14,13 +17,58 @@ namespace SDL{
 
             void DestroyTexture();
 
+            SDL_Texture* Get() const{ return m_texture; }
+            // Gives up ownership without destroying the texture.
+            SDL_Texture* Release(){ auto* texture = m_texture; m_texture = nullptr; return texture; }
+
+            struct Info{
+                uint32_t format;
+                int access;
+                int w;
+                int h;
+            };
+
+            Info QueryTexture() const;
+
+            void SetTextureBlendMode(SDL_BlendMode blendMode);
+            SDL_BlendMode GetTextureBlendMode() const;
+
+            void UpdateTexture(const Rect& rect, const void* pixels, int pitch);
+            void UpdateTexture(const void* pixels, int pitch);
+            // IYUV and YV12 textures; see PixelConvert for converting on the
+            // CPU instead.
+            void UpdateYUVTexture(const Rect& rect, const uint8_t* yPlane, int yPitch, const uint8_t* uPlane, int uPitch, const uint8_t* vPlane, int vPitch);
+            void UpdateYUVTexture(const uint8_t* yPlane, int yPitch, const uint8_t* uPlane, int uPitch, const uint8_t* vPlane, int vPitch);
+
+            // Keeps a region of a streaming texture locked for writing while
+            // alive. The pixels are write-only, their previous content is not
+            // guaranteed to be preserved.
+            class Lock{
+                public:
+                    Lock(Texture& texture, const Rect* rect);
+                    Lock(Lock&& other);
+                    Lock(const Lock&) = delete;
+                    Lock& operator=(const Lock&) = delete;
+                    ~Lock();
+
+                    void Unlock();
+
+                    void* GetPixels() const{ return m_pixels; }
+                    int GetPitch() const{ return m_pitch; }
+                    uint8_t* GetRow(int y) const{ return static_cast<uint8_t*>(m_pixels) + y * m_pitch; }
+
+                private:
+                    SDL_Texture* m_texture;
+                    void* m_pixels = nullptr;
+                    int m_pitch = 0;
+            };
+
+            Lock LockTexture(const Rect& rect);
+            Lock LockTexture();
+
 
         private:
             SDL_Texture* m_texture = nullptr;
-            // extern DECLSPEC int SDL_QueryTexture(SDL_Texture * texture,
-            //                                              uint32_t * format, int *access,
-            //                                              int *w, int *h);
-            // 
             // extern DECLSPEC int SDL_SetTextureColorMod(SDL_Texture * texture,
             //                                                    uint8_t r, uint8_t g, uint8_t b);
             // 
@@ -35,28 +83,6 @@ namespace SDL{
             // extern DECLSPEC int SDL_GetTextureAlphaMod(SDL_Texture * texture,
             //                                                    uint8_t * alpha);
             // 
-            // extern DECLSPEC int SDL_SetTextureBlendMode(SDL_Texture * texture,
-            //                                                     SDL_BlendMode blendMode);
-            // 
-            // extern DECLSPEC int SDL_GetTextureBlendMode(SDL_Texture * texture,
-            //                                                     SDL_BlendMode *blendMode);
-            // 
-            // extern DECLSPEC int SDL_UpdateTexture(SDL_Texture * texture,
-            //                                               const SDL_Rect * rect,
-            //                                               const void *pixels, int pitch);
-            // 
-            // extern DECLSPEC int SDL_UpdateYUVTexture(SDL_Texture * texture,
-            //                                                  const SDL_Rect * rect,
-            //                                                  const uint8_t *Yplane, int Ypitch,
-            //                                                  const uint8_t *Uplane, int Upitch,
-            //                                                  const uint8_t *Vplane, int Vpitch);
-            // 
-            // extern DECLSPEC int SDL_LockTexture(SDL_Texture * texture,
-            //                                             const SDL_Rect * rect,
-            //                                             void **pixels, int *pitch);
-            // 
-            // extern DECLSPEC void SDL_UnlockTexture(SDL_Texture * texture);
-            // 
             // extern DECLSPEC int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh);
             // 
             // extern DECLSPEC int SDL_GL_UnbindTexture(SDL_Texture *texture);
@@ -0,0 +1,114 @@
+#ifndef SDL2PP_TEXTUREPOOL
+#define SDL2PP_TEXTUREPOOL
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class SDL_Texture;
+
+namespace SDL{
+
+	class Texture;
+
+	// Recycles textures of one renderer. Textures handed out by Adopt() come
+	// back to the pool when their last reference is dropped and are given out
+	// again by Acquire() for the same format, access and size. Idle textures
+	// are kept up to a byte budget; the least recently released go first.
+	//
+	// Recycled textures keep their old pixels. Blend mode, color and alpha
+	// modulation are reset to the values of a new texture.
+	//
+	// Textures may be released on any thread: they are only queued, and the
+	// renderer's thread takes them back in Collect(), which Acquire() and
+	// every RenderPresent() call. All other calls belong on that thread too.
+	//
+	// The pool has to be owned by a std::shared_ptr and must only be used
+	// with the renderer that created its textures. Once the renderer is gone,
+	// textures released later are only unwrapped; SDL has freed them. Once
+	// the pool is gone, they are destroyed right away, so release them on
+	// the renderer's thread.
+	class TexturePool : public std::enable_shared_from_this<TexturePool>{
+		public:
+			struct Key{
+				uint32_t format;
+				int access;
+				int w;
+				int h;
+
+				bool operator==(const Key& other) const{
+					return format == other.format && access == other.access && w == other.w && h == other.h;
+				}
+			};
+
+			struct Stats{
+				uint64_t hits = 0;
+				uint64_t misses = 0;
+				uint64_t recycled = 0;
+				uint64_t evicted = 0;
+				std::size_t idleTextures = 0;
+				std::size_t idleBytes = 0;
+			};
+
+			TexturePool(std::size_t budgetBytes);
+			~TexturePool();
+
+			// Returns a recycled texture, or nullptr if none is idle.
+			std::shared_ptr<Texture> Acquire(const Key& key);
+			// Wraps a freshly created texture so that it returns to the pool.
+			std::shared_ptr<Texture> Adopt(SDL_Texture* texture, const Key& key);
+
+			// Resets the textures released since the last call and makes them
+			// idle, evicting the oldest beyond the budget.
+			void Collect();
+
+			void SetBudget(std::size_t budgetBytes);
+			std::size_t GetBudget() const{ return m_budget; }
+			void Trim(std::size_t targetBytes);
+			void Clear(){ Trim(0); }
+			// Destroys the idle textures and stops touching the ones still in
+			// use. Called before the renderer is destroyed.
+			void MarkRendererDestroyed();
+
+			Stats GetStats() const;
+			void ResetStats();
+
+			static std::size_t GetTextureBytes(const Key& key);
+
+		private:
+			struct KeyHash{
+				std::size_t operator()(const Key& key) const;
+			};
+
+			struct Idle{
+				Key key;
+				SDL_Texture* texture;
+				std::size_t bytes;
+			};
+
+			typedef std::list<Idle>::iterator IdleIterator;
+
+			std::shared_ptr<Texture> Wrap(SDL_Texture* texture, const Key& key);
+			void Release(SDL_Texture* texture, const Key& key);
+			void CollectLocked();
+			void TrimLocked(std::size_t targetBytes);
+
+			mutable std::mutex m_mutex;
+			std::size_t m_budget;
+			std::list<Idle> m_idle;
+			std::unordered_map<Key, std::vector<IdleIterator>, KeyHash> m_buckets;
+			// Released on any thread, waiting for Collect().
+			std::vector<Idle> m_released;
+			Stats m_stats;
+			// Shared with the deleters, which can outlive the pool.
+			std::shared_ptr<std::atomic<bool>> m_rendererAlive = std::make_shared<std::atomic<bool>>(true);
+	};
+
+}
+
+#endif
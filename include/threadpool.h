@@ -0,0 +1,69 @@
+#ifndef SDL2PP_THREADPOOL
+#define SDL2PP_THREADPOOL
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SDL{
+
+	// Fixed set of worker threads for data-parallel passes. Run() splits the
+	// indices into one contiguous block per thread; a thread that runs out of
+	// work steals from the far end of another thread's block. The calling
+	// thread works along as thread 0.
+	//
+	// Run() is not reentrant and must only be called from one thread.
+	class ThreadPool{
+		public:
+			typedef std::function<void(std::size_t index, unsigned thread)> Task;
+
+			// 0 uses one thread per CPU core.
+			explicit ThreadPool(unsigned threads = 0);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			// Worker threads plus the calling thread.
+			unsigned GetThreadCount() const{ return static_cast<unsigned>(m_queues.size()); }
+
+			// Calls task(index, thread) for every index below count and returns
+			// when all calls have finished. The first exception thrown by a
+			// task is rethrown here.
+			void Run(std::size_t count, const Task& task);
+
+		private:
+			struct Queue{
+				std::mutex mutex;
+				std::deque<std::size_t> indices;
+			};
+
+			void Work(unsigned thread);
+			bool Pop(unsigned thread, std::size_t& index);
+			void Execute(std::size_t index, unsigned thread);
+
+			std::vector<std::unique_ptr<Queue>> m_queues;
+			std::vector<std::thread> m_threads;
+
+			std::mutex m_mutex;
+			std::condition_variable m_wake;
+			std::condition_variable m_done;
+			uint64_t m_generation = 0;
+			bool m_stop = false;
+
+			const Task* m_task = nullptr;
+			std::atomic<std::size_t> m_remaining{0};
+			std::exception_ptr m_error;
+	};
+
+}
+
+#endif
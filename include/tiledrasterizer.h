@@ -0,0 +1,70 @@
+#ifndef SDL2PP_TILEDRASTERIZER
+#define SDL2PP_TILEDRASTERIZER
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SDL_blendmode.h>
+#include "commandbuffer.h"
+#include "rasterizer.h"
+#include "rect.h"
+#include "threadpool.h"
+
+class SDL_Surface;
+
+namespace SDL{
+
+	// Rasterizes recorded commands on all cores. Primitives are binned into
+	// square screen tiles and every tile replays its share of the commands in
+	// recording order with its own SurfaceRasterizer limited to the tile.
+	// Tiles never share pixels, so they write straight into the surface and
+	// the result matches drawing the commands on one thread.
+	class TiledRasterizer{
+		public:
+			// SurfaceRasterizer::Supports() and no surface locking needed.
+			static bool Supports(const SDL_Surface* surface);
+
+			// threads == 0 uses one thread per CPU core.
+			TiledRasterizer(SDL_Surface* surface, int tileSize = 128, unsigned threads = 0);
+
+			void SetBlendMode(SDL_BlendMode blendMode){ m_rasterizer.SetBlendMode(blendMode); }
+			void SetViewport(const Rect* rect){ m_rasterizer.SetViewport(rect); }
+			void SetClipRect(const Rect* rect){ m_rasterizer.SetClipRect(rect); }
+
+			// Draws commands [first, last) of the buffer, which must not hold
+			// copies in that range. Returns 0 or -1 like SurfaceRasterizer.
+			int Draw(const RenderCommandBuffer& buffer, std::size_t first, std::size_t last);
+
+			int GetTileSize() const{ return m_tileSize; }
+			std::size_t GetTileCount() const{ return m_bins.size(); }
+			unsigned GetThreadCount() const{ return m_pool.GetThreadCount(); }
+
+		private:
+			// Primitives [first, first + count) of one command; segments for
+			// lines.
+			struct Entry{
+				uint32_t command;
+				uint32_t first;
+				uint32_t count;
+			};
+
+			void Bin(const RenderCommandBuffer& buffer, std::size_t first, std::size_t last);
+			void BinAll(uint32_t command);
+			void BinRect(uint32_t command, uint32_t primitive, Rect rect, const Rect& visible);
+			int DrawTile(const RenderCommandBuffer& buffer, std::size_t tile, SurfaceRasterizer& rasterizer);
+
+			int m_tileSize;
+			int m_tilesX;
+			int m_tilesY;
+			// Holds the shared state; copied to every thread before a pass.
+			SurfaceRasterizer m_rasterizer;
+			std::vector<SurfaceRasterizer> m_threadRasterizers;
+			std::vector<std::vector<Entry>> m_bins;
+			std::vector<std::size_t> m_activeTiles;
+			std::vector<int> m_tileResults;
+			ThreadPool m_pool;
+	};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include "assetarchive.h"
+#include "error.h"
+#include "mappedfile.h"
+#include "renderer.h"
+#include "texture.h"
+#include <SDL_pixels.h>
+#include <SDL_render.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		template<typename Entry>
+		std::size_t FindByName(const Entry* entries, std::size_t count, const char* names, const std::string& name){
+			const auto* end = entries + count;
+			const auto* it = std::lower_bound(entries, end, name, [names](const Entry& entry, const std::string& key){
+				return std::strcmp(names + entry.name, key.c_str()) < 0;
+			});
+			return it != end && name == names + it->name ? static_cast<std::size_t>(it - entries) : AssetArchive::NotFound;
+		}
+
+	}
+
+	AssetArchive::AssetArchive(const std::string& path):m_file(std::make_shared<const MappedFile>(path)){
+		const auto* data = m_file->GetData();
+		const auto size = m_file->GetSize();
+		m_header = reinterpret_cast<const FileHeader*>(data);
+		if(size < sizeof(FileHeader) || std::memcmp(m_header->magic, "SPAK", 4) != 0)
+			throw Error("AssetArchive: not an archive: " + path);
+		if(m_header->version != Version)
+			throw Error("AssetArchive: unsupported version: " + path);
+
+		const auto tablesEnd = sizeof(FileHeader) + static_cast<uint64_t>(m_header->imageCount) * sizeof(FileImage)
+			+ static_cast<uint64_t>(m_header->spriteCount) * sizeof(FileSprite);
+		if(tablesEnd > m_header->namesOffset || static_cast<uint64_t>(m_header->namesOffset) + m_header->namesSize > size
+			|| m_header->namesSize == 0 || data[m_header->namesOffset + m_header->namesSize - 1] != 0)
+			throw Error("AssetArchive: corrupt index: " + path);
+		m_images = reinterpret_cast<const FileImage*>(data + sizeof(FileHeader));
+		m_sprites = reinterpret_cast<const FileSprite*>(m_images + m_header->imageCount);
+		m_names = reinterpret_cast<const char*>(data + m_header->namesOffset);
+
+		// Checked once here, so lookups and uploads can trust the tables.
+		for(std::size_t i = 0; i < m_header->imageCount; ++i){
+			const auto& image = m_images[i];
+			// SDL_BYTESPERPIXEL reads a character of the code for FOURCC formats.
+			const auto bytes = SDL_ISPIXELFORMAT_FOURCC(image.format) ? 0 : SDL_BYTESPERPIXEL(image.format);
+			if(image.name >= m_header->namesSize || image.width <= 0 || image.height <= 0 || bytes == 0
+				|| image.pitch < static_cast<int64_t>(image.width) * bytes || image.offset > size
+				|| static_cast<uint64_t>(image.pitch) * image.height > size - image.offset)
+				throw Error("AssetArchive: corrupt image entry: " + path);
+		}
+		for(std::size_t i = 0; i < m_header->spriteCount; ++i){
+			const auto& sprite = m_sprites[i];
+			if(sprite.name >= m_header->namesSize || sprite.image >= m_header->imageCount
+				|| sprite.x < 0 || sprite.y < 0 || sprite.w < 0 || sprite.h < 0
+				|| static_cast<int64_t>(sprite.x) + sprite.w > m_images[sprite.image].width
+				|| static_cast<int64_t>(sprite.y) + sprite.h > m_images[sprite.image].height)
+				throw Error("AssetArchive: corrupt sprite entry: " + path);
+		}
+		m_textures.resize(m_header->imageCount);
+	}
+
+	AssetArchive::~AssetArchive(){
+
+	}
+
+	std::size_t AssetArchive::FindImage(const std::string& name) const{
+		return FindByName(m_images, m_header->imageCount, m_names, name);
+	}
+
+	AssetArchive::Image AssetArchive::GetImage(std::size_t index) const{
+		if(index >= m_header->imageCount)
+			throw std::out_of_range("AssetArchive: invalid image");
+		const auto& image = m_images[index];
+		return Image{GetName(image.name), image.format, image.width, image.height, image.pitch, (image.flags & ImageAlpha) != 0, m_file->GetData() + image.offset};
+	}
+
+	std::size_t AssetArchive::FindSprite(const std::string& name) const{
+		return FindByName(m_sprites, m_header->spriteCount, m_names, name);
+	}
+
+	AssetArchive::Sprite AssetArchive::GetSprite(std::size_t index) const{
+		if(index >= m_header->spriteCount)
+			throw std::out_of_range("AssetArchive: invalid sprite");
+		const auto& sprite = m_sprites[index];
+		return Sprite{GetName(sprite.name), sprite.image, Rect{sprite.x, sprite.y, sprite.w, sprite.h}};
+	}
+
+	std::shared_ptr<Texture> AssetArchive::GetTexture(Renderer& renderer, std::size_t index){
+		const auto image = GetImage(index);
+		if(m_renderer != &renderer){
+			UnloadTextures();
+			m_renderer = &renderer;
+		}
+		if(m_textures[index] == nullptr){
+			auto texture = renderer.CreateTexture(image.format, SDL_TEXTUREACCESS_STATIC, image.width, image.height);
+			texture->UpdateTexture(image.pixels, image.pitch);
+			texture->SetTextureBlendMode(image.alpha ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+			m_textures[index] = std::move(texture);
+		}
+		return m_textures[index];
+	}
+
+	void AssetArchive::Prefetch(std::size_t index) const{
+		const auto image = GetImage(index);
+		m_file->Prefetch(m_images[index].offset, static_cast<std::size_t>(image.pitch) * image.height);
+	}
+
+	void AssetArchive::UnloadTextures(){
+		for(auto& texture : m_textures)
+			texture.reset();
+		m_renderer = nullptr;
+	}
+
+}
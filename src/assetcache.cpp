@@ -0,0 +1,43 @@
+#include "assetcache.h"
+#include "imageasset.h"
+#include "mappedfile.h"
+
+namespace SDL{
+
+	AssetCache::AssetCache(std::string root):m_root(std::move(root)){
+
+	}
+
+	std::shared_ptr<ImageAsset> AssetCache::Load(const std::string& path){
+		auto& asset = m_assets[path];
+		if(asset == nullptr){
+			try{
+				asset = std::make_shared<ImageAsset>(std::make_shared<const MappedFile>(m_root + path));
+			}catch(...){
+				m_assets.erase(path);
+				throw;
+			}
+		}
+		return asset;
+	}
+
+	std::shared_ptr<ImageAsset> AssetCache::Find(const std::string& path) const{
+		const auto it = m_assets.find(path);
+		return it != m_assets.end() ? it->second : nullptr;
+	}
+
+	void AssetCache::UnloadTextures(){
+		for(auto& asset : m_assets)
+			asset.second->Unload();
+	}
+
+	std::size_t AssetCache::GetLoadedCount() const{
+		std::size_t count = 0;
+		for(const auto& asset : m_assets){
+			if(asset.second->IsLoaded())
+				++count;
+		}
+		return count;
+	}
+
+}
@@ -0,0 +1,298 @@
+#include "atlas.h"
+#include "renderer.h"
+#include "texture.h"
+#include <SDL_pixels.h>
+#include <SDL_render.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		// Joins free rects sharing a whole edge, so erased neighbours become
+		// one hole instead of ever smaller pieces.
+		void AddFreeRect(std::vector<Rect>& freeRects, Rect rect){
+			for(std::size_t i = 0; i < freeRects.size();){
+				const auto& other = freeRects[i];
+				const auto sideBySide = other.y == rect.y && other.h == rect.h && (other.x + other.w == rect.x || rect.x + rect.w == other.x);
+				const auto stacked = other.x == rect.x && other.w == rect.w && (other.y + other.h == rect.y || rect.y + rect.h == other.y);
+				if(sideBySide || stacked){
+					const auto x = std::min(rect.x, other.x);
+					const auto y = std::min(rect.y, other.y);
+					rect = Rect{x, y, std::max(rect.x + rect.w, other.x + other.w) - x, std::max(rect.y + rect.h, other.y + other.h) - y};
+					freeRects[i] = freeRects.back();
+					freeRects.pop_back();
+					i = 0;
+				}else{
+					++i;
+				}
+			}
+			freeRects.push_back(rect);
+		}
+
+	}
+
+	SkylinePacker::SkylinePacker(int width, int height):m_width(width), m_height(height){
+		Reset();
+	}
+
+	void SkylinePacker::Reset(){
+		m_skyline.clear();
+		m_skyline.push_back(Node{0, 0, m_width});
+		m_usedArea = 0;
+	}
+
+	float SkylinePacker::GetOccupancy() const{
+		return static_cast<float>(m_usedArea) / (static_cast<float>(m_width) * m_height);
+	}
+
+	bool SkylinePacker::Fit(std::size_t index, int w, int h, int& y) const{
+		if(m_skyline[index].x + w > m_width)
+			return false;
+		y = m_skyline[index].y;
+		auto remaining = w;
+		for(auto i = index; remaining > 0; ++i){
+			if(i == m_skyline.size())
+				return false;
+			y = std::max(y, m_skyline[i].y);
+			if(y + h > m_height)
+				return false;
+			remaining -= m_skyline[i].w;
+		}
+		return true;
+	}
+
+	bool SkylinePacker::Insert(int w, int h, Rect& rect){
+		if(w <= 0 || h <= 0)
+			return false;
+
+		auto best = m_skyline.size();
+		auto bestTop = INT_MAX;
+		auto bestWidth = INT_MAX;
+		auto bestY = 0;
+		for(std::size_t i = 0; i < m_skyline.size(); ++i){
+			int y;
+			if(!Fit(i, w, h, y))
+				continue;
+			if(y + h < bestTop || (y + h == bestTop && m_skyline[i].w < bestWidth)){
+				best = i;
+				bestTop = y + h;
+				bestWidth = m_skyline[i].w;
+				bestY = y;
+			}
+		}
+		if(best == m_skyline.size())
+			return false;
+
+		rect = Rect{m_skyline[best].x, bestY, w, h};
+		m_skyline.insert(m_skyline.begin() + best, Node{rect.x, bestY + h, w});
+
+		// Cut the nodes now lying underneath the new one.
+		for(auto i = best + 1; i < m_skyline.size();){
+			const auto& previous = m_skyline[i - 1];
+			auto& node = m_skyline[i];
+			const auto previousEnd = previous.x + previous.w;
+			if(node.x >= previousEnd)
+				break;
+			const auto overlap = previousEnd - node.x;
+			node.x += overlap;
+			node.w -= overlap;
+			if(node.w > 0)
+				break;
+			m_skyline.erase(m_skyline.begin() + i);
+		}
+
+		for(std::size_t i = 0; i + 1 < m_skyline.size();){
+			if(m_skyline[i].y == m_skyline[i + 1].y){
+				m_skyline[i].w += m_skyline[i + 1].w;
+				m_skyline.erase(m_skyline.begin() + i + 1);
+			}else{
+				++i;
+			}
+		}
+
+		m_usedArea += static_cast<long long>(w) * h;
+		return true;
+	}
+
+
+	TextureAtlas::Page::Page(std::shared_ptr<Texture> texture, int width, int height):texture(std::move(texture)), packer(width, height){
+
+	}
+
+	TextureAtlas::TextureAtlas(Renderer& renderer, uint32_t format, int pageWidth, int pageHeight, int padding):
+		m_renderer(renderer),
+		m_format(format),
+		m_pageWidth(pageWidth),
+		m_pageHeight(pageHeight),
+		m_padding(padding){
+		if(pageWidth <= 0 || pageHeight <= 0 || padding < 0)
+			throw std::invalid_argument("TextureAtlas: invalid page size or padding");
+		if(SDL_ISPIXELFORMAT_FOURCC(format) || SDL_BYTESPERPIXEL(format) == 0)
+			throw std::invalid_argument("TextureAtlas: format must be a packed pixel format");
+	}
+
+	TextureAtlas::~TextureAtlas(){
+
+	}
+
+	TextureAtlas::Page& TextureAtlas::AddPage(){
+		auto texture = m_renderer.CreateTexture(m_format, SDL_TEXTUREACCESS_STATIC, m_pageWidth, m_pageHeight);
+		texture->SetTextureBlendMode(SDL_BLENDMODE_BLEND);
+		// Static textures start out undefined; unused space stays transparent.
+		const auto pitch = m_pageWidth * SDL_BYTESPERPIXEL(m_format);
+		m_scratch.assign(static_cast<std::size_t>(pitch) * m_pageHeight, 0);
+		texture->UpdateTexture(m_scratch.data(), pitch);
+		std::vector<uint8_t>().swap(m_scratch);
+		m_pages.push_back(std::make_unique<Page>(texture, m_pageWidth, m_pageHeight));
+		return *m_pages.back();
+	}
+
+	bool TextureAtlas::Allocate(Page& page, int w, int h, Rect& rect){
+		// Prefer the tightest hole left by erased regions.
+		auto best = page.freeRects.end();
+		auto bestArea = LLONG_MAX;
+		for(auto it = page.freeRects.begin(); it != page.freeRects.end(); ++it){
+			if(it->w < w || it->h < h)
+				continue;
+			const auto area = static_cast<long long>(it->w) * it->h;
+			if(area < bestArea){
+				best = it;
+				bestArea = area;
+			}
+		}
+
+		if(best == page.freeRects.end())
+			return page.packer.Insert(w, h, rect);
+
+		const auto hole = *best;
+		page.freeRects.erase(best);
+		rect = Rect{hole.x, hole.y, w, h};
+		if(hole.w > w)
+			AddFreeRect(page.freeRects, Rect{hole.x + w, hole.y, hole.w - w, h});
+		if(hole.h > h)
+			AddFreeRect(page.freeRects, Rect{hole.x, hole.y + h, hole.w, hole.h - h});
+		return true;
+	}
+
+	TextureAtlas::Handle TextureAtlas::Insert(int w, int h, const void* pixels, int pitch){
+		const auto allocW = w + 2 * m_padding;
+		const auto allocH = h + 2 * m_padding;
+		if(w <= 0 || h <= 0 || allocW > m_pageWidth || allocH > m_pageHeight)
+			throw std::invalid_argument("TextureAtlas: image and padding do not fit on a page");
+
+		Rect rect;
+		std::size_t index = 0;
+		for(; index < m_pages.size(); ++index){
+			if(Allocate(*m_pages[index], allocW, allocH, rect))
+				break;
+		}
+		if(index == m_pages.size()){
+			if(!Allocate(AddPage(), allocW, allocH, rect))
+				throw std::logic_error("TextureAtlas: allocation on an empty page failed");
+		}
+
+		auto& page = *m_pages[index];
+		Upload(page, rect, w, h, pixels, pitch);
+		rect = Rect{rect.x + m_padding, rect.y + m_padding, w, h};
+		++page.regions;
+		++m_liveRegions;
+
+		Handle handle;
+		if(m_freeHandles.empty()){
+			handle = static_cast<Handle>(m_entries.size());
+			m_entries.push_back(Entry{Region{index, rect}, true});
+		}else{
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+			m_entries[handle] = Entry{Region{index, rect}, true};
+		}
+		return handle;
+	}
+
+	void TextureAtlas::Erase(Handle handle){
+		if(handle >= m_entries.size() || !m_entries[handle].live)
+			throw std::out_of_range("TextureAtlas: invalid handle");
+
+		auto& entry = m_entries[handle];
+		auto& page = *m_pages[entry.region.page];
+		const auto& rect = entry.region.rect;
+		entry.live = false;
+		m_freeHandles.push_back(handle);
+		--m_liveRegions;
+
+		if(--page.regions == 0){
+			page.packer.Reset();
+			page.freeRects.clear();
+		}else{
+			AddFreeRect(page.freeRects, Rect{rect.x - m_padding, rect.y - m_padding, rect.w + 2 * m_padding, rect.h + 2 * m_padding});
+		}
+	}
+
+	void TextureAtlas::Upload(Page& page, const Rect& rect, int w, int h, const void* pixels, int pitch){
+		if(m_padding == 0){
+			page.texture->UpdateTexture(rect, pixels, pitch);
+			return;
+		}
+		// The gutter repeats the image's edge pixels, so filtering at the
+		// border samples the image and not its neighbours or stale pixels.
+		const auto bytes = SDL_BYTESPERPIXEL(m_format);
+		const auto paddedPitch = rect.w * bytes;
+		m_scratch.resize(static_cast<std::size_t>(paddedPitch) * rect.h);
+		for(auto y = 0; y < rect.h; ++y){
+			const auto sourceY = std::min(std::max(y - m_padding, 0), h - 1);
+			const auto* source = static_cast<const uint8_t*>(pixels) + static_cast<std::ptrdiff_t>(sourceY) * pitch;
+			auto* row = m_scratch.data() + static_cast<std::size_t>(y) * paddedPitch;
+			for(auto x = 0; x < m_padding; ++x){
+				std::memcpy(row + x * bytes, source, bytes);
+				std::memcpy(row + (m_padding + w + x) * bytes, source + (w - 1) * bytes, bytes);
+			}
+			std::memcpy(row + m_padding * bytes, source, static_cast<std::size_t>(w) * bytes);
+		}
+		page.texture->UpdateTexture(rect, m_scratch.data(), paddedPitch);
+	}
+
+	void TextureAtlas::Clear(){
+		for(auto& page : m_pages){
+			page->packer.Reset();
+			page->freeRects.clear();
+			page->regions = 0;
+			page->srcRects.clear();
+			page->dstRects.clear();
+		}
+		m_entries.clear();
+		m_freeHandles.clear();
+		m_liveRegions = 0;
+	}
+
+	const TextureAtlas::Region& TextureAtlas::GetRegion(Handle handle) const{
+		if(handle >= m_entries.size() || !m_entries[handle].live)
+			throw std::out_of_range("TextureAtlas: invalid handle");
+		return m_entries[handle].region;
+	}
+
+	std::shared_ptr<Texture> TextureAtlas::GetPage(std::size_t page) const{
+		return m_pages.at(page)->texture;
+	}
+
+	void TextureAtlas::RenderCopy(Handle handle, const Rect& dstRect){
+		const auto& region = GetRegion(handle);
+		auto& page = *m_pages[region.page];
+		page.srcRects.push_back(region.rect);
+		page.dstRects.push_back(dstRect);
+	}
+
+	void TextureAtlas::Flush(){
+		for(auto& page : m_pages){
+			if(page->srcRects.empty())
+				continue;
+			m_renderer.RenderCopies(*page->texture, page->srcRects, page->dstRects);
+			page->srcRects.clear();
+			page->dstRects.clear();
+		}
+	}
+
+}
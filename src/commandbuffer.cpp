@@ -0,0 +1,123 @@
+#include "commandbuffer.h"
+
+namespace SDL{
+
+	RenderCommandBuffer::RenderCommandBuffer(){
+
+	}
+
+	RenderCommandBuffer::RenderCommandBuffer(uint8_t r, uint8_t g, uint8_t b, uint8_t a):m_color{r, g, b, a}{
+
+	}
+
+	static bool SameColor(const RenderCommandBuffer::Color& lhs, const RenderCommandBuffer::Color& rhs){
+		return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+	}
+
+	RenderCommandBuffer::Command* RenderCommandBuffer::Extend(Type type, SDL_Texture* texture){
+		if(m_commands.empty())
+			return nullptr;
+		auto& last = m_commands.back();
+		if(last.type != type || last.texture != texture)
+			return nullptr;
+		if(type != Type::Copy && !SameColor(last.color, m_color))
+			return nullptr;
+		return &last;
+	}
+
+	void RenderCommandBuffer::Begin(Type type, uint32_t first, SDL_Texture* texture){
+		m_commands.push_back(Command{type, m_color, first, 0, texture});
+	}
+
+	void RenderCommandBuffer::SetDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+		m_color = Color{r, g, b, a};
+	}
+
+	void RenderCommandBuffer::Clear(){
+		// Everything recorded so far is about to be overwritten.
+		m_commands.clear();
+		m_points.clear();
+		m_rects.clear();
+		Begin(Type::Clear, 0);
+	}
+
+	void RenderCommandBuffer::DrawPoint(int x, int y){
+		if(Extend(Type::Points) == nullptr)
+			Begin(Type::Points, m_points.size());
+		m_points.push_back(Point{x, y});
+		++m_commands.back().count;
+	}
+
+	void RenderCommandBuffer::DrawPoints(const Point* points, std::size_t count){
+		if(count == 0)
+			return;
+		if(Extend(Type::Points) == nullptr)
+			Begin(Type::Points, m_points.size());
+		m_points.insert(m_points.end(), points, points + count);
+		m_commands.back().count += count;
+	}
+
+	void RenderCommandBuffer::DrawLine(int x1, int y1, int x2, int y2){
+		const Point line[] = {{x1, y1}, {x2, y2}};
+		DrawLines(line, 2);
+	}
+
+	void RenderCommandBuffer::DrawLines(const Point* points, std::size_t count){
+		if(count < 2)
+			return;
+		// Never extended: joining two calls into one polyline would draw the
+		// shared endpoint once instead of twice, which shows when blending.
+		Begin(Type::Lines, m_points.size());
+		m_points.insert(m_points.end(), points, points + count);
+		m_commands.back().count = count;
+	}
+
+	void RenderCommandBuffer::DrawRect(const Rect& rect){
+		DrawRects(&rect, 1);
+	}
+
+	void RenderCommandBuffer::DrawRects(const Rect* rects, std::size_t count){
+		if(count == 0)
+			return;
+		if(Extend(Type::Rects) == nullptr)
+			Begin(Type::Rects, m_rects.size());
+		m_rects.insert(m_rects.end(), rects, rects + count);
+		m_commands.back().count += count;
+	}
+
+	void RenderCommandBuffer::FillRect(const Rect& rect){
+		FillRects(&rect, 1);
+	}
+
+	void RenderCommandBuffer::FillRects(const Rect* rects, std::size_t count){
+		if(count == 0)
+			return;
+		if(Extend(Type::FillRects) == nullptr)
+			Begin(Type::FillRects, m_rects.size());
+		m_rects.insert(m_rects.end(), rects, rects + count);
+		m_commands.back().count += count;
+	}
+
+	void RenderCommandBuffer::Copy(SDL_Texture* texture, const Rect& srcRect, const Rect& dstRect){
+		Copy(texture, &srcRect, &dstRect, 1);
+	}
+
+	void RenderCommandBuffer::Copy(SDL_Texture* texture, const Rect* srcRects, const Rect* dstRects, std::size_t count){
+		if(count == 0)
+			return;
+		if(Extend(Type::Copy, texture) == nullptr)
+			Begin(Type::Copy, m_rects.size(), texture);
+		for(std::size_t i = 0; i < count; ++i){
+			m_rects.push_back(srcRects[i]);
+			m_rects.push_back(dstRects[i]);
+		}
+		m_commands.back().count += count;
+	}
+
+	void RenderCommandBuffer::Reset(){
+		m_commands.clear();
+		m_points.clear();
+		m_rects.clear();
+	}
+
+}
@@ -0,0 +1,83 @@
+#include "dirtypresenter.h"
+#include "texture.h"
+#include "window.h"
+#include <SDL_render.h>
+#include <stdexcept>
+
+namespace SDL{
+
+	DirtyPresenter::DirtyPresenter(Window& window, Mode mode, SoftwareBackend backend, std::size_t maxRects):
+		m_window(window),
+		m_mode(mode),
+		m_backend(backend),
+		m_dirty(0, 0, maxRects){
+		if(m_mode == Mode::Target){
+			m_renderer = window.GetRenderer();
+			if(!m_renderer)
+				throw std::logic_error("DirtyPresenter: the window has no renderer");
+			if(!m_renderer->RenderTargetSupported())
+				throw std::invalid_argument("DirtyPresenter: the renderer does not support render targets");
+		}
+		Resize();
+	}
+
+	DirtyPresenter::~DirtyPresenter(){
+
+	}
+
+	void DirtyPresenter::Invalidate(const Rect& rect){
+		m_dirty.Add(rect);
+	}
+
+	void DirtyPresenter::InvalidateAll(){
+		m_dirty.AddAll();
+	}
+
+	void DirtyPresenter::Resize(){
+		if(m_mode == Mode::Surface){
+			m_renderer = m_window.CreateSurfaceRenderer(m_backend);
+			const auto size = m_window.GetWindowSize();
+			m_dirty.Resize(size.x, size.y);
+		}else{
+			CreateTarget();
+		}
+	}
+
+	void DirtyPresenter::CreateTarget(){
+		const auto size = m_renderer->GetRendererOutputSize();
+		if(m_target && m_renderer->GetRenderTarget() == m_target)
+			m_renderer->SetRenderTarget(nullptr);
+		m_target.reset();
+		m_target = m_renderer->CreateTexture(SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+		m_target->SetTextureBlendMode(SDL_BLENDMODE_NONE);
+		m_dirty.Resize(size.x, size.y);
+	}
+
+	bool DirtyPresenter::Present(const DrawFunction& draw){
+		m_lastArea = m_dirty.GetArea();
+		if(m_dirty.Empty())
+			return false;
+
+		auto& renderer = *m_renderer;
+		if(m_mode == Mode::Target)
+			renderer.SetRenderTarget(m_target);
+		for(const auto& rect : m_dirty.GetRects()){
+			renderer.RenderSetClipRect(rect);
+			draw(renderer, rect);
+		}
+		renderer.RenderSetClipRect();
+
+		if(m_mode == Mode::Target){
+			renderer.SetRenderTarget(nullptr);
+			renderer.RenderCopy(*m_target);
+			renderer.RenderPresent();
+		}else{
+			// Finishes drawing; nothing reaches the screen until the update.
+			renderer.RenderPresent();
+			m_window.UpdateWindowSurfaceRects(m_dirty.GetRects());
+		}
+		m_dirty.Clear();
+		return true;
+	}
+
+}
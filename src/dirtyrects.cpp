@@ -0,0 +1,173 @@
+#include "dirtyrects.h"
+#include <algorithm>
+#include <climits>
+
+namespace SDL{
+
+	static long long Area(const Rect& rect){
+		return static_cast<long long>(rect.w) * rect.h;
+	}
+
+	static Rect Union(const Rect& a, const Rect& b){
+		const auto x1 = std::min(a.x, b.x);
+		const auto y1 = std::min(a.y, b.y);
+		const auto x2 = std::max(a.x + a.w, b.x + b.w);
+		const auto y2 = std::max(a.y + a.h, b.y + b.h);
+		return Rect{x1, y1, x2 - x1, y2 - y1};
+	}
+
+	// Overlapping or sharing an edge or corner.
+	static bool Touches(const Rect& a, const Rect& b){
+		return a.x <= b.x + b.w && b.x <= a.x + a.w && a.y <= b.y + b.h && b.y <= a.y + a.h;
+	}
+
+	static bool Overlaps(const Rect& a, const Rect& b){
+		return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+	}
+
+	// Area the union covers beyond a and b.
+	static long long Waste(const Rect& a, const Rect& b){
+		auto waste = Area(Union(a, b)) - Area(a) - Area(b);
+		if(Overlaps(a, b)){
+			const auto w = std::min(a.x + a.w, b.x + b.w) - std::max(a.x, b.x);
+			const auto h = std::min(a.y + a.h, b.y + b.h) - std::max(a.y, b.y);
+			waste += static_cast<long long>(w) * h;
+		}
+		return waste;
+	}
+
+	// At least three quarters of the union has to be dirty anyway.
+	static bool IsWorthMerging(const Rect& a, const Rect& b){
+		return Waste(a, b) * 4 <= Area(Union(a, b));
+	}
+
+	DirtyRects::DirtyRects(int width, int height, std::size_t maxRects):m_width(width), m_height(height), m_maxRects(std::max<std::size_t>(maxRects, 1)){
+
+	}
+
+	void DirtyRects::Resize(int width, int height){
+		m_width = width;
+		m_height = height;
+		AddAll();
+	}
+
+	void DirtyRects::Add(const Rect& rect){
+		const auto x1 = std::max(rect.x, 0);
+		const auto y1 = std::max(rect.y, 0);
+		const auto x2 = std::min(rect.x + rect.w, m_width);
+		const auto y2 = std::min(rect.y + rect.h, m_height);
+		if(x2 <= x1 || y2 <= y1)
+			return;
+		Insert(Rect{x1, y1, x2 - x1, y2 - y1});
+		Reduce();
+	}
+
+	void DirtyRects::Add(const DirtyRects& other){
+		for(const auto& rect : other.m_rects)
+			Add(rect);
+	}
+
+	void DirtyRects::AddAll(){
+		m_rects.clear();
+		if(m_width > 0 && m_height > 0)
+			m_rects.push_back(Rect{0, 0, m_width, m_height});
+	}
+
+	void DirtyRects::Insert(Rect rect){
+		for(std::size_t i = 0; i < m_rects.size(); ++i){
+			const auto other = m_rects[i];
+			if(!Overlaps(other, rect))
+				continue;
+			// Only the parts outside other are new: the bands above and below
+			// it and the pieces left and right of it.
+			const auto top = std::max(rect.y, other.y);
+			const auto bottom = std::min(rect.y + rect.h, other.y + other.h);
+			if(rect.y < top)
+				Insert(Rect{rect.x, rect.y, rect.w, top - rect.y});
+			if(bottom < rect.y + rect.h)
+				Insert(Rect{rect.x, bottom, rect.w, rect.y + rect.h - bottom});
+			if(rect.x < other.x)
+				Insert(Rect{rect.x, top, other.x - rect.x, bottom - top});
+			if(other.x + other.w < rect.x + rect.w)
+				Insert(Rect{other.x + other.w, top, rect.x + rect.w - other.x - other.w, bottom - top});
+			return;
+		}
+		Merge(rect);
+	}
+
+	void DirtyRects::Merge(Rect rect){
+		// Grow into touching rects while the union is mostly dirty anyway
+		// and stays clear of the other rects.
+		for(std::size_t i = 0; i < m_rects.size();){
+			const auto merged = Union(m_rects[i], rect);
+			auto clear = Touches(m_rects[i], rect) && IsWorthMerging(m_rects[i], rect);
+			for(std::size_t j = 0; clear && j < m_rects.size(); ++j)
+				clear = j == i || !Overlaps(m_rects[j], merged);
+			if(clear){
+				rect = merged;
+				m_rects[i] = m_rects.back();
+				m_rects.pop_back();
+				i = 0;
+			}else{
+				++i;
+			}
+		}
+		m_rects.push_back(rect);
+	}
+
+	void DirtyRects::Absorb(Rect rect){
+		// A merge can make the grown rect overlap rects it was apart from
+		// before, so keep going until nothing overlaps it any more.
+		for(std::size_t i = 0; i < m_rects.size();){
+			if(Overlaps(m_rects[i], rect)){
+				rect = Union(m_rects[i], rect);
+				m_rects[i] = m_rects.back();
+				m_rects.pop_back();
+				i = 0;
+			}else{
+				++i;
+			}
+		}
+		m_rects.push_back(rect);
+	}
+
+	void DirtyRects::Reduce(){
+		while(m_rects.size() > m_maxRects){
+			std::size_t bestA = 0, bestB = 1;
+			auto bestWaste = LLONG_MAX;
+			for(std::size_t a = 0; a < m_rects.size(); ++a){
+				for(auto b = a + 1; b < m_rects.size(); ++b){
+					const auto waste = Waste(m_rects[a], m_rects[b]);
+					if(waste < bestWaste){
+						bestWaste = waste;
+						bestA = a;
+						bestB = b;
+					}
+				}
+			}
+			const auto merged = Union(m_rects[bestA], m_rects[bestB]);
+			m_rects[bestB] = m_rects.back();
+			m_rects.pop_back();
+			m_rects[bestA] = m_rects.back();
+			m_rects.pop_back();
+			Absorb(merged);
+		}
+	}
+
+	long long DirtyRects::GetArea() const{
+		long long area = 0;
+		for(const auto& rect : m_rects)
+			area += Area(rect);
+		return area;
+	}
+
+	Rect DirtyRects::GetBounds() const{
+		if(m_rects.empty())
+			return Rect{0, 0, 0, 0};
+		auto bounds = m_rects.front();
+		for(const auto& rect : m_rects)
+			bounds = Union(bounds, rect);
+		return bounds;
+	}
+
+}
@@ -10,6 +10,10 @@ namespace SDL{
 
 	}
 
+	Error::Error(const std::string& message):runtime_error(message){
+
+	}
+
 	Error::~Error(){
 
 	}
@@ -0,0 +1,178 @@
+#include "eventloop.h"
+#include "profiler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		// Events moved or dispatched per batch.
+		const std::size_t BatchSize = 64;
+
+	}
+
+	EventQueue::EventQueue(std::size_t capacity){
+		if(capacity == 0)
+			throw std::invalid_argument("EventQueue: capacity must be positive");
+		std::size_t size = 2;
+		while(size < capacity)
+			size *= 2;
+		m_slots.reset(new Slot[size]);
+		m_mask = size - 1;
+		for(std::size_t i = 0; i < size; ++i)
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	bool EventQueue::Push(const SDL_Event& event){
+		if(TryPush(event))
+			return true;
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	bool EventQueue::TryPush(const SDL_Event& event){
+		auto position = m_tail.load(std::memory_order_relaxed);
+		for(;;){
+			auto& slot = m_slots[position & m_mask];
+			const auto sequence = slot.sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+			if(difference == 0){
+				if(m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)){
+					slot.event = event;
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}else if(difference < 0){
+				// The consumer has not freed this slot yet.
+				return false;
+			}else{
+				position = m_tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	std::size_t EventQueue::Pop(SDL_Event* events, std::size_t max){
+		auto position = m_head.load(std::memory_order_relaxed);
+		std::size_t count = 0;
+		while(count < max){
+			auto& slot = m_slots[position & m_mask];
+			if(slot.sequence.load(std::memory_order_acquire) != position + 1)
+				break;
+			events[count++] = slot.event;
+			slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+			++position;
+		}
+		m_head.store(position, std::memory_order_relaxed);
+		return count;
+	}
+
+	std::size_t EventQueue::GetSize() const{
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		const auto head = m_head.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+
+	EventLoop::EventLoop(std::size_t capacity):m_queue(capacity), m_wakeEvent(SDL_RegisterEvents(1)){
+		m_overflow.reserve(BatchSize);
+	}
+
+	EventLoop::~EventLoop(){
+
+	}
+
+	std::size_t EventLoop::Pump(){
+		// No profiler zone: the pump usually runs on its own thread.
+		SDL_PumpEvents();
+		// Events that did not fit last time go first, so input keeps its
+		// order.
+		std::size_t queued = 0;
+		while(queued < m_overflow.size() && m_queue.TryPush(m_overflow[queued]))
+			++queued;
+		m_overflow.erase(m_overflow.begin(), m_overflow.begin() + queued);
+		if(!m_overflow.empty())
+			return queued;
+
+		SDL_Event batch[BatchSize];
+		for(;;){
+			// Leave what does not fit in SDL's queue for the next pump. Other
+			// threads may push meanwhile, so the space is only a hint.
+			const auto space = m_queue.GetCapacity() - std::min(m_queue.GetSize(), m_queue.GetCapacity());
+			if(space == 0)
+				break;
+			const auto count = SDL_PeepEvents(batch, static_cast<int>(std::min(space, BatchSize)), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+			if(count <= 0)
+				break;
+			auto i = 0;
+			for(; i < count; ++i){
+				if(batch[i].type == m_wakeEvent)
+					continue;
+				if(!m_queue.TryPush(batch[i]))
+					break;
+				++queued;
+			}
+			if(i < count){
+				// Producers filled the ring first; keep the rest for the next
+				// pump.
+				for(; i < count; ++i){
+					if(batch[i].type != m_wakeEvent)
+						m_overflow.push_back(batch[i]);
+				}
+				break;
+			}
+			if(static_cast<std::size_t>(count) < BatchSize)
+				break;
+		}
+		return queued;
+	}
+
+	void EventLoop::Run(int timeoutMs){
+		while(IsRunning()){
+			// Returns as soon as an event is queued, without removing it.
+			// Held back events are retried every millisecond.
+			if(SDL_WaitEventTimeout(nullptr, m_overflow.empty() ? timeoutMs : 1) != 0 || !m_overflow.empty())
+				Pump();
+		}
+	}
+
+	void EventLoop::Quit(){
+		m_quit.store(true, std::memory_order_release);
+		if(m_wakeEvent != static_cast<uint32_t>(-1)){
+			SDL_Event event{};
+			event.type = m_wakeEvent;
+			SDL_PushEvent(&event);
+		}
+	}
+
+	void EventLoop::SetHandler(uint32_t type, Handler handler){
+		m_handlers[type] = std::move(handler);
+	}
+
+	void EventLoop::RemoveHandler(uint32_t type){
+		m_handlers.erase(type);
+	}
+
+	void EventLoop::SetDefaultHandler(Handler handler){
+		m_defaultHandler = std::move(handler);
+	}
+
+	std::size_t EventLoop::Dispatch(){
+		SDL2PP_PROFILE_ZONE(EventDispatch);
+		std::size_t total = 0;
+		SDL_Event batch[BatchSize];
+		for(;;){
+			const auto count = m_queue.Pop(batch, BatchSize);
+			for(std::size_t i = 0; i < count; ++i){
+				const auto handler = m_handlers.find(batch[i].type);
+				if(handler != m_handlers.end())
+					handler->second(batch[i]);
+				else if(m_defaultHandler)
+					m_defaultHandler(batch[i]);
+			}
+			total += count;
+			if(count < BatchSize)
+				return total;
+		}
+	}
+
+}
@@ -0,0 +1,123 @@
+#include "framescheduler.h"
+#include "window.h"
+#include <SDL_timer.h>
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+namespace SDL{
+
+	const std::size_t FrameScheduler::HistoryLength;
+
+	FrameScheduler::FrameScheduler():m_frequency(static_cast<double>(SDL_GetPerformanceFrequency())){
+
+	}
+
+	FrameScheduler::SwapInterval FrameScheduler::SetSwapInterval(SwapInterval interval){
+		if(interval == SwapInterval::Adaptive){
+			if(Window::GL_SetSwapInterval(-1, std::nothrow))
+				return SwapInterval::Adaptive;
+			interval = SwapInterval::Vsync;
+		}
+		if(interval == SwapInterval::Vsync && Window::GL_SetSwapInterval(1, std::nothrow))
+			return SwapInterval::Vsync;
+		Window::GL_SetSwapInterval(0, std::nothrow);
+		return SwapInterval::Immediate;
+	}
+
+	void FrameScheduler::SetFixedTimestep(double seconds){
+		if(seconds < 0.0)
+			throw std::invalid_argument("FrameScheduler: negative timestep");
+		m_timestep = seconds;
+		m_accumulator = 0.0;
+	}
+
+	void FrameScheduler::SetFrameRateCap(double fps){
+		if(fps < 0.0)
+			throw std::invalid_argument("FrameScheduler: negative frame rate");
+		m_capTicks = fps > 0.0 ? static_cast<uint64_t>(m_frequency / fps) : 0;
+	}
+
+	int FrameScheduler::BeginFrame(){
+		const auto now = SDL_GetPerformanceCounter();
+		if(!m_started){
+			m_started = true;
+			m_delta = 0.0;
+		}else{
+			m_delta = Seconds(now - m_frameStart);
+			m_frameTimes[m_next] = static_cast<float>(m_delta);
+			m_next = (m_next + 1) % HistoryLength;
+			m_history = std::min(m_history + 1, HistoryLength);
+			if(m_budget > 0.0 && m_delta > m_budget * 1.5)
+				++m_missed;
+		}
+		m_frameStart = now;
+
+		if(m_timestep <= 0.0)
+			return 0;
+		m_accumulator += m_delta;
+		auto steps = static_cast<int>(m_accumulator / m_timestep);
+		if(steps > m_maxSteps){
+			steps = m_maxSteps;
+			m_accumulator = m_timestep * steps;
+		}
+		m_accumulator -= m_timestep * steps;
+		return steps;
+	}
+
+	void FrameScheduler::EndFrame(){
+		const auto now = SDL_GetPerformanceCounter();
+		// The entry for this frame's duration is written by the next
+		// BeginFrame(); the work time goes into the same slot.
+		m_workTimes[m_next] = static_cast<float>(Seconds(now - m_frameStart));
+		if(m_capTicks != 0)
+			SleepUntil(m_frameStart + m_capTicks);
+	}
+
+	void FrameScheduler::SleepUntil(uint64_t deadline){
+		// Sleep in 1 ms steps and only spin the last stretch, at most 2 ms.
+		// SDL raises the Windows timer resolution to 1 ms by default; where
+		// the timer stays coarse the frame oversleeps instead of burning a
+		// core.
+		for(;;){
+			const auto now = SDL_GetPerformanceCounter();
+			if(now >= deadline)
+				return;
+			if(Seconds(deadline - now) <= m_sleepMargin)
+				break;
+			SDL_Delay(1);
+			const auto slept = Seconds(SDL_GetPerformanceCounter() - now);
+			m_sleepMargin = std::min(std::max(m_sleepMargin * 0.9 + slept * 0.1, 0.001), 0.002);
+		}
+		while(SDL_GetPerformanceCounter() < deadline)
+			std::this_thread::yield();
+	}
+
+	FrameScheduler::Stats FrameScheduler::GetStats() const{
+		Stats stats;
+		stats.missed = m_missed;
+		stats.frames = m_history;
+		if(m_history == 0)
+			return stats;
+
+		double sum = 0.0, work = 0.0;
+		stats.min = m_frameTimes[0];
+		stats.max = m_frameTimes[0];
+		for(std::size_t i = 0; i < m_history; ++i){
+			sum += m_frameTimes[i];
+			work += m_workTimes[i];
+			stats.min = std::min<double>(stats.min, m_frameTimes[i]);
+			stats.max = std::max<double>(stats.max, m_frameTimes[i]);
+		}
+		stats.mean = sum / m_history;
+		stats.meanWork = work / m_history;
+		double variance = 0.0;
+		for(std::size_t i = 0; i < m_history; ++i)
+			variance += (m_frameTimes[i] - stats.mean) * (m_frameTimes[i] - stats.mean);
+		stats.jitter = std::sqrt(variance / m_history);
+		return stats;
+	}
+
+}
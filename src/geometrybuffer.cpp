@@ -0,0 +1,592 @@
+#include "geometrybuffer.h"
+#include <SDL_cpuinfo.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SDL2PP_GEOMETRYBUFFER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SDL2PP_GEOMETRYBUFFER_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDL2PP_GEOMETRYBUFFER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace SDL{
+
+	static_assert(sizeof(Point) == 2 * sizeof(int), "SDL_Point must be two ints");
+	static_assert(sizeof(Rect) == 4 * sizeof(int), "SDL_Rect must be four ints");
+
+	namespace{
+
+		const std::size_t StorageAlignment = 64;
+
+		// The in-place kernels may run past count up to the capacity, which
+		// is a multiple of CoordinateStorage::Granularity; the others stop at
+		// count. Range kernels widen min and max.
+		typedef void (*AddFunc)(int* values, std::size_t count, int delta);
+		typedef void (*ScaleFunc)(int* values, std::size_t count, float scale, float offset);
+		typedef void (*ScaleExtentFunc)(int* position, int* extent, std::size_t count, float scale, float offset);
+		typedef void (*ClipExtentFunc)(int* position, int* extent, std::size_t count, int low, int high);
+		typedef void (*RangeFunc)(const int* values, std::size_t count, int& min, int& max);
+		// Min of position, max of position + extent.
+		typedef void (*ExtentRangeFunc)(const int* position, const int* extent, std::size_t count, int& min, int& max);
+		typedef void (*Interleave2Func)(const int* x, const int* y, int* dst, std::size_t count);
+		typedef void (*Interleave4Func)(const int* x, const int* y, const int* w, const int* h, int* dst, std::size_t count);
+
+		// Rounds to nearest even like cvtps2dq in the default rounding mode.
+		inline int ScaleValue(int value, float scale, float offset){
+			return static_cast<int>(std::nearbyint(static_cast<float>(value) * scale + offset));
+		}
+
+		void RangeScalar(const int* values, std::size_t count, int& min, int& max){
+			for(std::size_t i = 0; i < count; ++i){
+				min = std::min(min, values[i]);
+				max = std::max(max, values[i]);
+			}
+		}
+
+		void ExtentRangeScalar(const int* position, const int* extent, std::size_t count, int& min, int& max){
+			for(std::size_t i = 0; i < count; ++i){
+				min = std::min(min, position[i]);
+				max = std::max(max, position[i] + extent[i]);
+			}
+		}
+
+		void Interleave2Scalar(const int* x, const int* y, int* dst, std::size_t count){
+			for(std::size_t i = 0; i < count; ++i){
+				dst[2 * i] = x[i];
+				dst[2 * i + 1] = y[i];
+			}
+		}
+
+		void Interleave4Scalar(const int* x, const int* y, const int* w, const int* h, int* dst, std::size_t count){
+			for(std::size_t i = 0; i < count; ++i){
+				dst[4 * i] = x[i];
+				dst[4 * i + 1] = y[i];
+				dst[4 * i + 2] = w[i];
+				dst[4 * i + 3] = h[i];
+			}
+		}
+
+#ifndef SDL2PP_GEOMETRYBUFFER_SSE2
+		void AddScalar(int* values, std::size_t count, int delta){
+			for(std::size_t i = 0; i < count; ++i)
+				values[i] += delta;
+		}
+
+		void ScaleScalar(int* values, std::size_t count, float scale, float offset){
+			for(std::size_t i = 0; i < count; ++i)
+				values[i] = ScaleValue(values[i], scale, offset);
+		}
+
+		void ScaleExtentScalar(int* position, int* extent, std::size_t count, float scale, float offset){
+			for(std::size_t i = 0; i < count; ++i){
+				const auto start = ScaleValue(position[i], scale, offset);
+				extent[i] = ScaleValue(position[i] + extent[i], scale, offset) - start;
+				position[i] = start;
+			}
+		}
+
+		void ClipExtentScalar(int* position, int* extent, std::size_t count, int low, int high){
+			for(std::size_t i = 0; i < count; ++i){
+				const auto start = std::max(position[i], low);
+				extent[i] = std::min(position[i] + extent[i], high) - start;
+				position[i] = start;
+			}
+		}
+#else
+		// SSE2 has no 32-bit min and max.
+		inline __m128i MinSSE2(__m128i a, __m128i b){
+			const auto greater = _mm_cmpgt_epi32(a, b);
+			return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+		}
+
+		inline __m128i MaxSSE2(__m128i a, __m128i b){
+			const auto greater = _mm_cmpgt_epi32(a, b);
+			return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+		}
+
+		void ReduceSSE2(__m128i low, __m128i high, int& min, int& max){
+			alignas(16) int lows[4], highs[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lows), low);
+			_mm_store_si128(reinterpret_cast<__m128i*>(highs), high);
+			for(auto i = 0; i < 4; ++i){
+				min = std::min(min, lows[i]);
+				max = std::max(max, highs[i]);
+			}
+		}
+
+		void AddSSE2(int* values, std::size_t count, int delta){
+			const auto add = _mm_set1_epi32(delta);
+			for(std::size_t i = 0; i < count; i += 4){
+				auto* p = reinterpret_cast<__m128i*>(values + i);
+				_mm_store_si128(p, _mm_add_epi32(_mm_load_si128(p), add));
+			}
+		}
+
+		inline __m128i ScaleVectorSSE2(__m128i values, __m128 scale, __m128 offset){
+			return _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(values), scale), offset));
+		}
+
+		void ScaleSSE2(int* values, std::size_t count, float scale, float offset){
+			const auto s = _mm_set1_ps(scale), o = _mm_set1_ps(offset);
+			for(std::size_t i = 0; i < count; i += 4){
+				auto* p = reinterpret_cast<__m128i*>(values + i);
+				_mm_store_si128(p, ScaleVectorSSE2(_mm_load_si128(p), s, o));
+			}
+		}
+
+		void ScaleExtentSSE2(int* position, int* extent, std::size_t count, float scale, float offset){
+			const auto s = _mm_set1_ps(scale), o = _mm_set1_ps(offset);
+			for(std::size_t i = 0; i < count; i += 4){
+				auto* p = reinterpret_cast<__m128i*>(position + i);
+				auto* e = reinterpret_cast<__m128i*>(extent + i);
+				const auto start = _mm_load_si128(p);
+				const auto end = _mm_add_epi32(start, _mm_load_si128(e));
+				const auto scaledStart = ScaleVectorSSE2(start, s, o);
+				_mm_store_si128(p, scaledStart);
+				_mm_store_si128(e, _mm_sub_epi32(ScaleVectorSSE2(end, s, o), scaledStart));
+			}
+		}
+
+		void ClipExtentSSE2(int* position, int* extent, std::size_t count, int low, int high){
+			const auto l = _mm_set1_epi32(low), h = _mm_set1_epi32(high);
+			for(std::size_t i = 0; i < count; i += 4){
+				auto* p = reinterpret_cast<__m128i*>(position + i);
+				auto* e = reinterpret_cast<__m128i*>(extent + i);
+				const auto start = _mm_load_si128(p);
+				const auto end = _mm_add_epi32(start, _mm_load_si128(e));
+				const auto clippedStart = MaxSSE2(start, l);
+				_mm_store_si128(p, clippedStart);
+				_mm_store_si128(e, _mm_sub_epi32(MinSSE2(end, h), clippedStart));
+			}
+		}
+
+		void RangeSSE2(const int* values, std::size_t count, int& min, int& max){
+			std::size_t i = 0;
+			if(count >= 4){
+				auto low = _mm_load_si128(reinterpret_cast<const __m128i*>(values));
+				auto high = low;
+				for(i = 4; i + 4 <= count; i += 4){
+					const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(values + i));
+					low = MinSSE2(low, v);
+					high = MaxSSE2(high, v);
+				}
+				ReduceSSE2(low, high, min, max);
+			}
+			RangeScalar(values + i, count - i, min, max);
+		}
+
+		void ExtentRangeSSE2(const int* position, const int* extent, std::size_t count, int& min, int& max){
+			std::size_t i = 0;
+			if(count >= 4){
+				auto low = _mm_load_si128(reinterpret_cast<const __m128i*>(position));
+				auto high = _mm_add_epi32(low, _mm_load_si128(reinterpret_cast<const __m128i*>(extent)));
+				for(i = 4; i + 4 <= count; i += 4){
+					const auto start = _mm_load_si128(reinterpret_cast<const __m128i*>(position + i));
+					const auto end = _mm_add_epi32(start, _mm_load_si128(reinterpret_cast<const __m128i*>(extent + i)));
+					low = MinSSE2(low, start);
+					high = MaxSSE2(high, end);
+				}
+				ReduceSSE2(low, high, min, max);
+			}
+			ExtentRangeScalar(position + i, extent + i, count - i, min, max);
+		}
+
+		// The packed buffer is a plain vector, hence the unaligned stores.
+		void Interleave2SSE2(const int* x, const int* y, int* dst, std::size_t count){
+			std::size_t i = 0;
+			for(; i + 4 <= count; i += 4){
+				const auto vx = _mm_load_si128(reinterpret_cast<const __m128i*>(x + i));
+				const auto vy = _mm_load_si128(reinterpret_cast<const __m128i*>(y + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi32(vx, vy));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 4), _mm_unpackhi_epi32(vx, vy));
+			}
+			Interleave2Scalar(x + i, y + i, dst + 2 * i, count - i);
+		}
+
+		void Interleave4SSE2(const int* x, const int* y, const int* w, const int* h, int* dst, std::size_t count){
+			std::size_t i = 0;
+			for(; i + 4 <= count; i += 4){
+				// 4x4 transpose.
+				const auto vx = _mm_load_si128(reinterpret_cast<const __m128i*>(x + i));
+				const auto vy = _mm_load_si128(reinterpret_cast<const __m128i*>(y + i));
+				const auto vw = _mm_load_si128(reinterpret_cast<const __m128i*>(w + i));
+				const auto vh = _mm_load_si128(reinterpret_cast<const __m128i*>(h + i));
+				const auto xy01 = _mm_unpacklo_epi32(vx, vy), xy23 = _mm_unpackhi_epi32(vx, vy);
+				const auto wh01 = _mm_unpacklo_epi32(vw, vh), wh23 = _mm_unpackhi_epi32(vw, vh);
+				auto* out = reinterpret_cast<__m128i*>(dst + 4 * i);
+				_mm_storeu_si128(out, _mm_unpacklo_epi64(xy01, wh01));
+				_mm_storeu_si128(out + 1, _mm_unpackhi_epi64(xy01, wh01));
+				_mm_storeu_si128(out + 2, _mm_unpacklo_epi64(xy23, wh23));
+				_mm_storeu_si128(out + 3, _mm_unpackhi_epi64(xy23, wh23));
+			}
+			Interleave4Scalar(x + i, y + i, w + i, h + i, dst + 4 * i, count - i);
+		}
+#endif
+
+#ifdef SDL2PP_GEOMETRYBUFFER_AVX2
+		__attribute__((target("avx2")))
+		void AddAVX2(int* values, std::size_t count, int delta){
+			const auto add = _mm256_set1_epi32(delta);
+			for(std::size_t i = 0; i < count; i += 8){
+				auto* p = reinterpret_cast<__m256i*>(values + i);
+				_mm256_store_si256(p, _mm256_add_epi32(_mm256_load_si256(p), add));
+			}
+		}
+
+		__attribute__((target("avx2")))
+		inline __m256i ScaleVectorAVX2(__m256i values, __m256 scale, __m256 offset){
+			return _mm256_cvtps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(values), scale), offset));
+		}
+
+		__attribute__((target("avx2")))
+		void ScaleAVX2(int* values, std::size_t count, float scale, float offset){
+			const auto s = _mm256_set1_ps(scale), o = _mm256_set1_ps(offset);
+			for(std::size_t i = 0; i < count; i += 8){
+				auto* p = reinterpret_cast<__m256i*>(values + i);
+				_mm256_store_si256(p, ScaleVectorAVX2(_mm256_load_si256(p), s, o));
+			}
+		}
+
+		__attribute__((target("avx2")))
+		void ScaleExtentAVX2(int* position, int* extent, std::size_t count, float scale, float offset){
+			const auto s = _mm256_set1_ps(scale), o = _mm256_set1_ps(offset);
+			for(std::size_t i = 0; i < count; i += 8){
+				auto* p = reinterpret_cast<__m256i*>(position + i);
+				auto* e = reinterpret_cast<__m256i*>(extent + i);
+				const auto start = _mm256_load_si256(p);
+				const auto end = _mm256_add_epi32(start, _mm256_load_si256(e));
+				const auto scaledStart = ScaleVectorAVX2(start, s, o);
+				_mm256_store_si256(p, scaledStart);
+				_mm256_store_si256(e, _mm256_sub_epi32(ScaleVectorAVX2(end, s, o), scaledStart));
+			}
+		}
+
+		__attribute__((target("avx2")))
+		void ClipExtentAVX2(int* position, int* extent, std::size_t count, int low, int high){
+			const auto l = _mm256_set1_epi32(low), h = _mm256_set1_epi32(high);
+			for(std::size_t i = 0; i < count; i += 8){
+				auto* p = reinterpret_cast<__m256i*>(position + i);
+				auto* e = reinterpret_cast<__m256i*>(extent + i);
+				const auto start = _mm256_load_si256(p);
+				const auto end = _mm256_add_epi32(start, _mm256_load_si256(e));
+				const auto clippedStart = _mm256_max_epi32(start, l);
+				_mm256_store_si256(p, clippedStart);
+				_mm256_store_si256(e, _mm256_sub_epi32(_mm256_min_epi32(end, h), clippedStart));
+			}
+		}
+
+		__attribute__((target("avx2")))
+		void ReduceAVX2(__m256i low, __m256i high, int& min, int& max){
+			alignas(32) int lows[8], highs[8];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lows), low);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(highs), high);
+			for(auto i = 0; i < 8; ++i){
+				min = std::min(min, lows[i]);
+				max = std::max(max, highs[i]);
+			}
+		}
+
+		__attribute__((target("avx2")))
+		void RangeAVX2(const int* values, std::size_t count, int& min, int& max){
+			std::size_t i = 0;
+			if(count >= 8){
+				auto low = _mm256_load_si256(reinterpret_cast<const __m256i*>(values));
+				auto high = low;
+				for(i = 8; i + 8 <= count; i += 8){
+					const auto v = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+					low = _mm256_min_epi32(low, v);
+					high = _mm256_max_epi32(high, v);
+				}
+				ReduceAVX2(low, high, min, max);
+			}
+			RangeScalar(values + i, count - i, min, max);
+		}
+
+		__attribute__((target("avx2")))
+		void ExtentRangeAVX2(const int* position, const int* extent, std::size_t count, int& min, int& max){
+			std::size_t i = 0;
+			if(count >= 8){
+				auto low = _mm256_load_si256(reinterpret_cast<const __m256i*>(position));
+				auto high = _mm256_add_epi32(low, _mm256_load_si256(reinterpret_cast<const __m256i*>(extent)));
+				for(i = 8; i + 8 <= count; i += 8){
+					const auto start = _mm256_load_si256(reinterpret_cast<const __m256i*>(position + i));
+					const auto end = _mm256_add_epi32(start, _mm256_load_si256(reinterpret_cast<const __m256i*>(extent + i)));
+					low = _mm256_min_epi32(low, start);
+					high = _mm256_max_epi32(high, end);
+				}
+				ReduceAVX2(low, high, min, max);
+			}
+			ExtentRangeScalar(position + i, extent + i, count - i, min, max);
+		}
+
+		__attribute__((target("avx2")))
+		void Interleave2AVX2(const int* x, const int* y, int* dst, std::size_t count){
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8){
+				const auto vx = _mm256_load_si256(reinterpret_cast<const __m256i*>(x + i));
+				const auto vy = _mm256_load_si256(reinterpret_cast<const __m256i*>(y + i));
+				// Unpacking works per 128-bit lane: points 0, 1, 4, 5 and 2, 3, 6, 7.
+				const auto low = _mm256_unpacklo_epi32(vx, vy), high = _mm256_unpackhi_epi32(vx, vy);
+				auto* out = reinterpret_cast<__m256i*>(dst + 2 * i);
+				_mm256_storeu_si256(out, _mm256_permute2x128_si256(low, high, 0x20));
+				_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(low, high, 0x31));
+			}
+			Interleave2SSE2(x + i, y + i, dst + 2 * i, count - i);
+		}
+
+		__attribute__((target("avx2")))
+		void Interleave4AVX2(const int* x, const int* y, const int* w, const int* h, int* dst, std::size_t count){
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8){
+				const auto vx = _mm256_load_si256(reinterpret_cast<const __m256i*>(x + i));
+				const auto vy = _mm256_load_si256(reinterpret_cast<const __m256i*>(y + i));
+				const auto vw = _mm256_load_si256(reinterpret_cast<const __m256i*>(w + i));
+				const auto vh = _mm256_load_si256(reinterpret_cast<const __m256i*>(h + i));
+				// A 4x4 transpose per lane: rects 0 and 4, 1 and 5, 2 and 6, 3 and 7.
+				const auto xyLow = _mm256_unpacklo_epi32(vx, vy), xyHigh = _mm256_unpackhi_epi32(vx, vy);
+				const auto whLow = _mm256_unpacklo_epi32(vw, vh), whHigh = _mm256_unpackhi_epi32(vw, vh);
+				const auto r04 = _mm256_unpacklo_epi64(xyLow, whLow), r15 = _mm256_unpackhi_epi64(xyLow, whLow);
+				const auto r26 = _mm256_unpacklo_epi64(xyHigh, whHigh), r37 = _mm256_unpackhi_epi64(xyHigh, whHigh);
+				auto* out = reinterpret_cast<__m256i*>(dst + 4 * i);
+				_mm256_storeu_si256(out, _mm256_permute2x128_si256(r04, r15, 0x20));
+				_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(r26, r37, 0x20));
+				_mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(r04, r15, 0x31));
+				_mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(r26, r37, 0x31));
+			}
+			Interleave4SSE2(x + i, y + i, w + i, h + i, dst + 4 * i, count - i);
+		}
+#endif
+
+		struct Kernels{
+			AddFunc add;
+			ScaleFunc scale;
+			ScaleExtentFunc scaleExtent;
+			ClipExtentFunc clipExtent;
+			RangeFunc range;
+			ExtentRangeFunc extentRange;
+			Interleave2Func interleave2;
+			Interleave4Func interleave4;
+		};
+
+		Kernels SelectKernels(){
+#ifdef SDL2PP_GEOMETRYBUFFER_AVX2
+			if(SDL_HasAVX2())
+				return Kernels{AddAVX2, ScaleAVX2, ScaleExtentAVX2, ClipExtentAVX2, RangeAVX2, ExtentRangeAVX2, Interleave2AVX2, Interleave4AVX2};
+#endif
+#ifdef SDL2PP_GEOMETRYBUFFER_SSE2
+			return Kernels{AddSSE2, ScaleSSE2, ScaleExtentSSE2, ClipExtentSSE2, RangeSSE2, ExtentRangeSSE2, Interleave2SSE2, Interleave4SSE2};
+#else
+			return Kernels{AddScalar, ScaleScalar, ScaleExtentScalar, ClipExtentScalar, RangeScalar, ExtentRangeScalar, Interleave2Scalar, Interleave4Scalar};
+#endif
+		}
+
+		const Kernels& GetKernels(){
+			static const Kernels kernels = SelectKernels();
+			return kernels;
+		}
+
+	}
+
+	CoordinateStorage::CoordinateStorage(int components):m_components(components){
+
+	}
+
+	CoordinateStorage::CoordinateStorage(const CoordinateStorage& other):m_components(other.m_components){
+		*this = other;
+	}
+
+	CoordinateStorage::CoordinateStorage(CoordinateStorage&& other) noexcept:m_components(other.m_components){
+		*this = std::move(other);
+	}
+
+	CoordinateStorage& CoordinateStorage::operator=(const CoordinateStorage& other){
+		if(this == &other)
+			return *this;
+		if(m_components != other.m_components){
+			m_allocation.reset();
+			m_data = nullptr;
+			m_capacity = 0;
+			m_components = other.m_components;
+		}
+		m_size = 0;
+		Reserve(other.m_size);
+		for(auto component = 0; component < m_components; ++component)
+			std::memcpy(GetComponent(component), other.GetComponent(component), other.m_size * sizeof(int));
+		m_size = other.m_size;
+		return *this;
+	}
+
+	CoordinateStorage& CoordinateStorage::operator=(CoordinateStorage&& other) noexcept{
+		if(this == &other)
+			return *this;
+		m_components = other.m_components;
+		m_allocation = std::move(other.m_allocation);
+		m_data = other.m_data;
+		m_size = other.m_size;
+		m_capacity = other.m_capacity;
+		other.m_data = nullptr;
+		other.m_size = 0;
+		other.m_capacity = 0;
+		return *this;
+	}
+
+	void CoordinateStorage::Reserve(std::size_t capacity){
+		if(capacity <= m_capacity)
+			return;
+		capacity = (capacity + Granularity - 1) / Granularity * Granularity;
+		// Zeroed, so the kernels never read uninitialized padding.
+		std::unique_ptr<unsigned char[]> allocation(new unsigned char[m_components * capacity * sizeof(int) + StorageAlignment - 1]());
+		const auto address = reinterpret_cast<uintptr_t>(allocation.get());
+		auto* data = reinterpret_cast<int*>((address + StorageAlignment - 1) & ~static_cast<uintptr_t>(StorageAlignment - 1));
+		for(auto component = 0; component < m_components; ++component){
+			if(m_size > 0)
+				std::memcpy(data + component * capacity, GetComponent(component), m_size * sizeof(int));
+		}
+		m_allocation = std::move(allocation);
+		m_data = data;
+		m_capacity = capacity;
+	}
+
+	void CoordinateStorage::Resize(std::size_t size){
+		if(size > m_size){
+			Reserve(size);
+			for(auto component = 0; component < m_components; ++component)
+				std::fill(GetComponent(component) + m_size, GetComponent(component) + size, 0);
+		}
+		m_size = size;
+	}
+
+	void PointBuffer::Append(Span<const Point> points){
+		const auto first = m_storage.Grow(points.size());
+		auto* x = GetX() + first;
+		auto* y = GetY() + first;
+		for(std::size_t i = 0; i < points.size(); ++i){
+			x[i] = points[i].x;
+			y[i] = points[i].y;
+		}
+	}
+
+	void PointBuffer::Translate(int dx, int dy){
+		const auto& kernels = GetKernels();
+		kernels.add(GetX(), GetSize(), dx);
+		kernels.add(GetY(), GetSize(), dy);
+	}
+
+	void PointBuffer::Scale(float scaleX, float scaleY, float offsetX, float offsetY){
+		const auto& kernels = GetKernels();
+		kernels.scale(GetX(), GetSize(), scaleX, offsetX);
+		kernels.scale(GetY(), GetSize(), scaleY, offsetY);
+	}
+
+	void PointBuffer::Clip(const Rect& rect){
+		if(rect.w <= 0 || rect.h <= 0){
+			Clear();
+			return;
+		}
+		auto* x = GetX();
+		auto* y = GetY();
+		const auto right = rect.x + rect.w, bottom = rect.y + rect.h;
+		// Branchless: every point is written, only the kept ones advance.
+		std::size_t kept = 0;
+		for(std::size_t i = 0; i < GetSize(); ++i){
+			const auto px = x[i], py = y[i];
+			x[kept] = px;
+			y[kept] = py;
+			kept += px >= rect.x && px < right && py >= rect.y && py < bottom;
+		}
+		m_storage.Truncate(kept);
+	}
+
+	Rect PointBuffer::GetBoundingBox() const{
+		if(IsEmpty())
+			return Rect{0, 0, 0, 0};
+		const auto& kernels = GetKernels();
+		auto minX = INT_MAX, maxX = INT_MIN, minY = INT_MAX, maxY = INT_MIN;
+		kernels.range(GetX(), GetSize(), minX, maxX);
+		kernels.range(GetY(), GetSize(), minY, maxY);
+		return Rect{minX, minY, maxX - minX + 1, maxY - minY + 1};
+	}
+
+	Span<const Point> PointBuffer::Pack(){
+		if(m_packed.size() < GetSize())
+			m_packed.resize(GetSize());
+		GetKernels().interleave2(GetX(), GetY(), reinterpret_cast<int*>(m_packed.data()), GetSize());
+		return Span<const Point>(m_packed.data(), GetSize());
+	}
+
+	void RectBuffer::Append(Span<const Rect> rects){
+		const auto first = m_storage.Grow(rects.size());
+		auto* x = GetX() + first;
+		auto* y = GetY() + first;
+		auto* w = GetW() + first;
+		auto* h = GetH() + first;
+		for(std::size_t i = 0; i < rects.size(); ++i){
+			x[i] = rects[i].x;
+			y[i] = rects[i].y;
+			w[i] = rects[i].w;
+			h[i] = rects[i].h;
+		}
+	}
+
+	void RectBuffer::Translate(int dx, int dy){
+		const auto& kernels = GetKernels();
+		kernels.add(GetX(), GetSize(), dx);
+		kernels.add(GetY(), GetSize(), dy);
+	}
+
+	void RectBuffer::Scale(float scaleX, float scaleY, float offsetX, float offsetY){
+		const auto& kernels = GetKernels();
+		kernels.scaleExtent(GetX(), GetW(), GetSize(), scaleX, offsetX);
+		kernels.scaleExtent(GetY(), GetH(), GetSize(), scaleY, offsetY);
+	}
+
+	void RectBuffer::Clip(const Rect& rect){
+		if(rect.w <= 0 || rect.h <= 0){
+			Clear();
+			return;
+		}
+		const auto& kernels = GetKernels();
+		kernels.clipExtent(GetX(), GetW(), GetSize(), rect.x, rect.x + rect.w);
+		kernels.clipExtent(GetY(), GetH(), GetSize(), rect.y, rect.y + rect.h);
+
+		auto* x = GetX();
+		auto* y = GetY();
+		auto* w = GetW();
+		auto* h = GetH();
+		std::size_t kept = 0;
+		for(std::size_t i = 0; i < GetSize(); ++i){
+			const auto rw = w[i], rh = h[i];
+			x[kept] = x[i];
+			y[kept] = y[i];
+			w[kept] = rw;
+			h[kept] = rh;
+			kept += rw > 0 && rh > 0;
+		}
+		m_storage.Truncate(kept);
+	}
+
+	Rect RectBuffer::GetBoundingBox() const{
+		if(IsEmpty())
+			return Rect{0, 0, 0, 0};
+		const auto& kernels = GetKernels();
+		auto minX = INT_MAX, maxX = INT_MIN, minY = INT_MAX, maxY = INT_MIN;
+		kernels.extentRange(GetX(), GetW(), GetSize(), minX, maxX);
+		kernels.extentRange(GetY(), GetH(), GetSize(), minY, maxY);
+		return Rect{minX, minY, maxX - minX, maxY - minY};
+	}
+
+	Span<const Rect> RectBuffer::Pack(){
+		if(m_packed.size() < GetSize())
+			m_packed.resize(GetSize());
+		GetKernels().interleave4(GetX(), GetY(), GetW(), GetH(), reinterpret_cast<int*>(m_packed.data()), GetSize());
+		return Span<const Rect>(m_packed.data(), GetSize());
+	}
+
+}
@@ -0,0 +1,303 @@
+#include "imageasset.h"
+#include "error.h"
+#include "mappedfile.h"
+#include "pixelconvert.h"
+#include "profiler.h"
+#include "renderer.h"
+#include "texture.h"
+#include <SDL_pixels.h>
+#include <SDL_render.h>
+#include <cstring>
+#include <vector>
+
+namespace SDL{
+
+	namespace{
+
+		// BI_RGB, BI_BITFIELDS, BI_ALPHABITFIELDS
+		const uint32_t BMPRGB = 0;
+		const uint32_t BMPBitfields = 3;
+		const uint32_t BMPAlphaBitfields = 6;
+
+		const std::size_t QOIHeaderSize = 14;
+		const std::size_t QOIPaddingSize = 8;
+		// Same limit as the reference decoder.
+		const uint64_t QOIPixelsMax = 400000000;
+		// A run op covers at most 62 pixels per byte.
+		const uint64_t QOIPixelsPerByte = 62;
+		// Scratch kept between decodes; larger images free theirs after use.
+		const std::size_t ScratchKeepPixels = 1024 * 1024;
+
+		uint16_t ReadU16(const uint8_t* p){
+			return static_cast<uint16_t>(p[0] | p[1] << 8);
+		}
+
+		uint32_t ReadU32(const uint8_t* p){
+			return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24;
+		}
+
+		uint32_t ReadU32BE(const uint8_t* p){
+			return static_cast<uint32_t>(p[0]) << 24 | p[1] << 16 | p[2] << 8 | p[3];
+		}
+
+		struct BMPHeader{
+			int width;
+			int height;
+			bool bottomUp;
+			int bits;
+			// Source format for PixelConvert; 0 for palette images.
+			uint32_t format;
+			bool alpha;
+			const uint8_t* pixels;
+			std::size_t pitch;
+			const uint8_t* palette;
+			uint32_t paletteSize;
+		};
+
+		uint32_t BitfieldFormat(uint32_t r, uint32_t g, uint32_t b, uint32_t a){
+			if(r == 0x00FF0000 && g == 0x0000FF00 && b == 0x000000FF)
+				return a == 0xFF000000 ? SDL_PIXELFORMAT_ARGB8888 : SDL_PIXELFORMAT_RGB888;
+			if(r == 0x000000FF && g == 0x0000FF00 && b == 0x00FF0000)
+				return a == 0xFF000000 ? SDL_PIXELFORMAT_ABGR8888 : SDL_PIXELFORMAT_BGR888;
+			if(r == 0xFF000000 && g == 0x00FF0000 && b == 0x0000FF00 && a == 0x000000FF)
+				return SDL_PIXELFORMAT_RGBA8888;
+			if(r == 0x0000FF00 && g == 0x00FF0000 && b == 0xFF000000 && a == 0x000000FF)
+				return SDL_PIXELFORMAT_BGRA8888;
+			if(r == 0xF800 && g == 0x07E0 && b == 0x001F)
+				return SDL_PIXELFORMAT_RGB565;
+			return 0;
+		}
+
+		BMPHeader ParseBMP(const uint8_t* data, std::size_t size){
+			if(size < 54 || data[0] != 'B' || data[1] != 'M')
+				throw Error("ImageAsset: not a BMP or QOI image");
+			const auto dataOffset = ReadU32(data + 10);
+			const auto headerSize = ReadU32(data + 14);
+			if(headerSize < 40 || 14 + static_cast<uint64_t>(headerSize) > size)
+				throw Error("ImageAsset: unsupported BMP header");
+
+			BMPHeader header;
+			const int64_t width = static_cast<int32_t>(ReadU32(data + 18));
+			const int64_t height = static_cast<int32_t>(ReadU32(data + 22));
+			// Negative heights are stored top to bottom.
+			if(width <= 0 || width > 65535 || height == 0 || height > 65535 || height < -65535)
+				throw Error("ImageAsset: invalid BMP size");
+			header.width = static_cast<int>(width);
+			header.height = static_cast<int>(height > 0 ? height : -height);
+			header.bottomUp = height > 0;
+			header.bits = ReadU16(data + 28);
+			const auto compression = ReadU32(data + 30);
+
+			header.format = 0;
+			header.alpha = false;
+			header.palette = nullptr;
+			header.paletteSize = 0;
+			if(compression == BMPRGB){
+				switch(header.bits){
+					case 1:
+					case 4:
+					case 8:{
+						const auto colors = ReadU32(data + 46);
+						header.paletteSize = colors != 0 && colors < (1u << header.bits) ? colors : 1u << header.bits;
+						header.palette = data + 14 + headerSize;
+						if(14 + headerSize + static_cast<uint64_t>(header.paletteSize) * 4 > size)
+							throw Error("ImageAsset: truncated BMP palette");
+						break;
+					}
+					case 24:
+						header.format = SDL_PIXELFORMAT_BGR24;
+						break;
+					case 32:
+						// The fourth byte is unused without bitfields.
+						header.format = SDL_PIXELFORMAT_RGB888;
+						break;
+					default:
+						throw Error("ImageAsset: unsupported BMP bit depth");
+				}
+			}else if((compression == BMPBitfields || compression == BMPAlphaBitfields) && (header.bits == 16 || header.bits == 32)){
+				// The masks follow a 40 byte header or are part of a larger one.
+				const auto hasAlphaMask = compression == BMPAlphaBitfields || headerSize >= 56;
+				if(54 + (hasAlphaMask ? 16 : 12) > size)
+					throw Error("ImageAsset: truncated BMP header");
+				const auto a = hasAlphaMask ? ReadU32(data + 66) : 0;
+				header.format = BitfieldFormat(ReadU32(data + 54), ReadU32(data + 58), ReadU32(data + 62), a);
+				if(header.format == 0 || SDL_BYTESPERPIXEL(header.format) * 8 != static_cast<uint32_t>(header.bits))
+					throw Error("ImageAsset: unsupported BMP bitfields");
+				header.alpha = header.format == SDL_PIXELFORMAT_ARGB8888 || header.format == SDL_PIXELFORMAT_ABGR8888
+					|| header.format == SDL_PIXELFORMAT_RGBA8888 || header.format == SDL_PIXELFORMAT_BGRA8888;
+			}else{
+				throw Error("ImageAsset: compressed BMP not supported");
+			}
+
+			header.pitch = (static_cast<std::size_t>(header.width) * header.bits + 31) / 32 * 4;
+			if(static_cast<uint64_t>(dataOffset) + static_cast<uint64_t>(header.pitch) * header.height > size)
+				throw Error("ImageAsset: truncated BMP pixels");
+			header.pixels = data + dataOffset;
+			return header;
+		}
+
+		void DecodeBMP(const BMPHeader& header, uint8_t* pixels, int pitch){
+			if(header.format != 0){
+				const PixelConvert convert(header.format, SDL_PIXELFORMAT_ARGB8888);
+				for(auto y = 0; y < header.height; ++y)
+					convert.ConvertRow(header.pixels + (header.bottomUp ? header.height - 1 - y : y) * header.pitch, pixels + y * pitch, header.width);
+				return;
+			}
+
+			const auto mask = (1u << header.bits) - 1;
+			for(auto y = 0; y < header.height; ++y){
+				const auto* src = header.pixels + (header.bottomUp ? header.height - 1 - y : y) * header.pitch;
+				auto* dst = reinterpret_cast<uint32_t*>(pixels + y * pitch);
+				for(auto x = 0; x < header.width; ++x){
+					const auto bit = x * header.bits;
+					const auto index = (src[bit / 8] >> (8 - header.bits - bit % 8)) & mask;
+					// Out of range indices are black, as in SDL.
+					if(index >= header.paletteSize){
+						dst[x] = 0xFF000000;
+						continue;
+					}
+					const auto* color = header.palette + index * 4;
+					dst[x] = 0xFF000000u | color[2] << 16 | color[1] << 8 | color[0];
+				}
+			}
+		}
+
+		struct QOIColor{
+			uint8_t r, g, b, a;
+		};
+
+		void DecodeQOI(const uint8_t* data, std::size_t size, int width, int height, uint8_t* pixels, int pitch){
+			QOIColor index[64] = {};
+			QOIColor color{0, 0, 0, 255};
+			const auto end = size - QOIPaddingSize;
+			auto p = QOIHeaderSize;
+			auto run = 0;
+			for(auto y = 0; y < height; ++y){
+				auto* dst = reinterpret_cast<uint32_t*>(pixels + y * pitch);
+				for(auto x = 0; x < width; ++x){
+					if(run > 0){
+						--run;
+					}else{
+						if(p >= end)
+							throw Error("ImageAsset: truncated QOI data");
+						const auto op = data[p++];
+						if(op == 0xFE){
+							if(end - p < 3)
+								throw Error("ImageAsset: truncated QOI data");
+							color.r = data[p];
+							color.g = data[p + 1];
+							color.b = data[p + 2];
+							p += 3;
+						}else if(op == 0xFF){
+							if(end - p < 4)
+								throw Error("ImageAsset: truncated QOI data");
+							color = QOIColor{data[p], data[p + 1], data[p + 2], data[p + 3]};
+							p += 4;
+						}else{
+							switch(op >> 6){
+								case 0:
+									color = index[op];
+									break;
+								case 1:
+									color.r += ((op >> 4) & 3) - 2;
+									color.g += ((op >> 2) & 3) - 2;
+									color.b += (op & 3) - 2;
+									break;
+								case 2:{
+									if(p >= end)
+										throw Error("ImageAsset: truncated QOI data");
+									const auto next = data[p++];
+									const auto dg = (op & 0x3F) - 32;
+									color.r += dg - 8 + (next >> 4);
+									color.g += dg;
+									color.b += dg - 8 + (next & 0x0F);
+									break;
+								}
+								case 3:
+									run = op & 0x3F;
+									break;
+							}
+						}
+						index[(color.r * 3 + color.g * 5 + color.b * 7 + color.a * 11) % 64] = color;
+					}
+					dst[x] = static_cast<uint32_t>(color.a) << 24 | color.r << 16 | color.g << 8 | color.b;
+				}
+			}
+		}
+
+	}
+
+	ImageAsset::ImageAsset(std::shared_ptr<const MappedFile> file, std::size_t offset, std::size_t size):m_file(std::move(file)){
+		if(offset > m_file->GetSize() || size > m_file->GetSize() - offset)
+			throw std::invalid_argument("ImageAsset: range outside of the file");
+		m_data = m_file->GetData() + offset;
+		m_size = size;
+
+		if(m_size >= QOIHeaderSize + QOIPaddingSize && std::memcmp(m_data, "qoif", 4) == 0){
+			m_format = Format::QOI;
+			const auto width = ReadU32BE(m_data + 4);
+			const auto height = ReadU32BE(m_data + 8);
+			if(width == 0 || height == 0 || width > 65535 || height > 65535)
+				throw Error("ImageAsset: invalid QOI size");
+			const auto pixels = static_cast<uint64_t>(width) * height;
+			if(pixels > QOIPixelsMax)
+				throw Error("ImageAsset: QOI image too large");
+			if((pixels + QOIPixelsPerByte - 1) / QOIPixelsPerByte > m_size - QOIHeaderSize - QOIPaddingSize)
+				throw Error("ImageAsset: truncated QOI data");
+			m_width = static_cast<int>(width);
+			m_height = static_cast<int>(height);
+			m_alpha = m_data[12] == 4;
+		}else{
+			m_format = Format::BMP;
+			const auto header = ParseBMP(m_data, m_size);
+			m_width = header.width;
+			m_height = header.height;
+			m_alpha = header.alpha;
+		}
+	}
+
+	ImageAsset::ImageAsset(std::shared_ptr<const MappedFile> file):ImageAsset(file, 0, file->GetSize()){
+
+	}
+
+	void ImageAsset::Decode(void* pixels, int pitch) const{
+		auto* out = static_cast<uint8_t*>(pixels);
+		if(m_format == Format::QOI)
+			DecodeQOI(m_data, m_size, m_width, m_height, out, pitch);
+		else
+			DecodeBMP(ParseBMP(m_data, m_size), out, pitch);
+	}
+
+	std::shared_ptr<Texture> ImageAsset::GetTexture(Renderer& renderer){
+		if(m_texture != nullptr && m_renderer == &renderer)
+			return m_texture;
+		SDL2PP_PROFILE_ZONE(DecodeImage);
+
+		auto texture = renderer.CreateTexture(SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, m_width, m_height);
+		const auto header = m_format == Format::BMP ? ParseBMP(m_data, m_size) : BMPHeader{};
+		if(m_format == Format::BMP && header.format == SDL_PIXELFORMAT_ARGB8888 && !header.bottomUp){
+			// Already in texture layout, uploaded straight from the mapping.
+			texture->UpdateTexture(header.pixels, static_cast<int>(header.pitch));
+		}else{
+			// Shared by all decodes on this thread, up to ScratchKeepPixels.
+			static thread_local std::vector<uint32_t> scratch;
+			const auto pixels = static_cast<std::size_t>(m_width) * m_height;
+			scratch.resize(pixels);
+			Decode(scratch.data(), m_width * 4);
+			texture->UpdateTexture(scratch.data(), m_width * 4);
+			if(pixels > ScratchKeepPixels)
+				std::vector<uint32_t>().swap(scratch);
+		}
+		texture->SetTextureBlendMode(m_alpha ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+
+		m_texture = std::move(texture);
+		m_renderer = &renderer;
+		return m_texture;
+	}
+
+	void ImageAsset::Unload(){
+		m_texture.reset();
+		m_renderer = nullptr;
+	}
+
+}
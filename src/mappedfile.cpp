@@ -0,0 +1,95 @@
+#include "mappedfile.h"
+#include "error.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SDL{
+
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& path):m_path(path){
+		const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(file == INVALID_HANDLE_VALUE)
+			throw Error("MappedFile: cannot open " + path);
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(file, &size)){
+			CloseHandle(file);
+			throw Error("MappedFile: cannot stat " + path);
+		}
+		m_size = static_cast<std::size_t>(size.QuadPart);
+		// Empty files cannot be mapped and need no mapping.
+		if(m_size != 0){
+			m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(m_mapping != nullptr)
+				m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		CloseHandle(file);
+		if(m_size != 0 && m_data == nullptr){
+			if(m_mapping != nullptr)
+				CloseHandle(m_mapping);
+			throw Error("MappedFile: cannot map " + path);
+		}
+	}
+
+	MappedFile::~MappedFile(){
+		if(m_data != nullptr)
+			UnmapViewOfFile(m_data);
+		if(m_mapping != nullptr)
+			CloseHandle(m_mapping);
+	}
+
+	void MappedFile::Prefetch(std::size_t, std::size_t) const{
+
+	}
+#else
+	MappedFile::MappedFile(const std::string& path):m_path(path){
+		const auto file = open(path.c_str(), O_RDONLY);
+		if(file < 0)
+			throw Error("MappedFile: cannot open " + path + ": " + std::strerror(errno));
+		struct stat info;
+		if(fstat(file, &info) != 0){
+			const auto error = errno;
+			close(file);
+			throw Error("MappedFile: cannot stat " + path + ": " + std::strerror(error));
+		}
+		m_size = static_cast<std::size_t>(info.st_size);
+		if(m_size != 0){
+			auto* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if(data == MAP_FAILED){
+				const auto error = errno;
+				close(file);
+				throw Error("MappedFile: cannot map " + path + ": " + std::strerror(error));
+			}
+			m_data = static_cast<const uint8_t*>(data);
+		}
+		// The mapping keeps the file alive.
+		close(file);
+	}
+
+	MappedFile::~MappedFile(){
+		if(m_data != nullptr)
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+
+	void MappedFile::Prefetch(std::size_t offset, std::size_t size) const{
+		if(offset >= m_size)
+			return;
+		size = std::min(size, m_size - offset);
+		// madvise wants a page-aligned start.
+		const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+		const auto begin = offset / page * page;
+		madvise(const_cast<uint8_t*>(m_data) + begin, size + offset - begin, MADV_WILLNEED);
+	}
+#endif
+
+}
@@ -0,0 +1,491 @@
+#include "pixelconvert.h"
+#include "error.h"
+#include <SDL_cpuinfo.h>
+#include <SDL_pixels.h>
+#include <SDL_surface.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SDL2PP_PIXELCONVERT_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SDL2PP_PIXELCONVERT_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDL2PP_PIXELCONVERT_SSSE3
+#include <immintrin.h>
+#endif
+
+namespace SDL{
+
+	namespace{
+
+		typedef void (*ShuffleFunc)(const uint8_t* src, uint8_t* dst, int width, const PixelConvert::Shuffle& shuffle);
+		typedef void (*Expand565Func)(const uint16_t* src, uint32_t* dst, int width);
+		typedef void (*Pack565Func)(const uint32_t* src, uint16_t* dst, int width);
+		// One row of YUV to ARGB8888. Chroma of pixel i is at u[i / 2 * uvStep].
+		typedef void (*YUVRowFunc)(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uvStep, uint32_t* dst, int width);
+
+		// Pixels converted per step when a conversion goes through ARGB8888.
+		const int ChunkSize = 256;
+
+		// Byte offsets of the channels in memory, -1 for none.
+		struct Layout{
+			uint32_t format;
+			int bytes;
+			int8_t r, g, b, a;
+		};
+
+		const Layout layouts[] = {
+			{SDL_PIXELFORMAT_ARGB8888, 4, 2, 1, 0, 3},
+			{SDL_PIXELFORMAT_RGBA8888, 4, 3, 2, 1, 0},
+			{SDL_PIXELFORMAT_ABGR8888, 4, 0, 1, 2, 3},
+			{SDL_PIXELFORMAT_BGRA8888, 4, 1, 2, 3, 0},
+			{SDL_PIXELFORMAT_RGB888, 4, 2, 1, 0, -1},
+			{SDL_PIXELFORMAT_BGR888, 4, 0, 1, 2, -1},
+			{SDL_PIXELFORMAT_RGB24, 3, 0, 1, 2, -1},
+			{SDL_PIXELFORMAT_BGR24, 3, 2, 1, 0, -1},
+			{SDL_PIXELFORMAT_RGB565, 2, -1, -1, -1, -1}
+		};
+
+		const Layout* FindLayout(uint32_t format){
+			for(const auto& layout : layouts){
+				if(layout.format == format)
+					return &layout;
+			}
+			return nullptr;
+		}
+
+		PixelConvert::Shuffle MakeShuffle(const Layout& src, const Layout& dst){
+			PixelConvert::Shuffle shuffle;
+			shuffle.srcBytes = src.bytes;
+			shuffle.dstBytes = dst.bytes;
+			for(auto j = 0; j < 4; ++j){
+				int8_t from = -1;
+				if(j == dst.r)
+					from = src.r;
+				else if(j == dst.g)
+					from = src.g;
+				else if(j == dst.b)
+					from = src.b;
+				else if(j == dst.a)
+					from = src.a;
+				shuffle.map[j] = from;
+			}
+			for(auto i = 0; i < 16; ++i){
+				shuffle.mask[i] = 0x80;
+				shuffle.fill[i] = 0;
+			}
+			for(auto pixel = 0; pixel < 4; ++pixel){
+				for(auto j = 0; j < dst.bytes; ++j){
+					const auto from = shuffle.map[j];
+					shuffle.mask[pixel * dst.bytes + j] = from >= 0 ? static_cast<uint8_t>(pixel * src.bytes + from) : 0x80;
+					shuffle.fill[pixel * dst.bytes + j] = from >= 0 ? 0 : 0xFF;
+				}
+			}
+			return shuffle;
+		}
+
+		void ShuffleScalar(const uint8_t* src, uint8_t* dst, int width, const PixelConvert::Shuffle& shuffle){
+			for(auto i = 0; i < width; ++i){
+				uint8_t in[4];
+				std::memcpy(in, src + i * shuffle.srcBytes, shuffle.srcBytes);
+				auto* out = dst + i * shuffle.dstBytes;
+				for(auto j = 0; j < shuffle.dstBytes; ++j)
+					out[j] = shuffle.map[j] >= 0 ? in[shuffle.map[j]] : 0xFF;
+			}
+		}
+
+		// Bit replication, 31 -> 255 and 63 -> 255, as SDL expands.
+		inline uint32_t Expand565(uint16_t pixel){
+			const uint32_t r = pixel >> 11, g = (pixel >> 5) & 0x3F, b = pixel & 0x1F;
+			return 0xFF000000u | ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+		}
+
+		// Truncates like SDL.
+		inline uint16_t Pack565(uint32_t pixel){
+			return static_cast<uint16_t>(((pixel >> 8) & 0xF800) | ((pixel >> 5) & 0x07E0) | ((pixel >> 3) & 0x001F));
+		}
+
+		void Expand565Scalar(const uint16_t* src, uint32_t* dst, int width){
+			for(auto i = 0; i < width; ++i)
+				dst[i] = Expand565(src[i]);
+		}
+
+		void Pack565Scalar(const uint32_t* src, uint16_t* dst, int width){
+			for(auto i = 0; i < width; ++i)
+				dst[i] = Pack565(src[i]);
+		}
+
+		// BT.601 limited range in 6-bit fixed point; the SIMD kernels use the
+		// same factors and produce the same bytes.
+		inline uint8_t ClampShift(int value){
+			return static_cast<uint8_t>(std::min(std::max((value + 32) >> 6, 0), 255));
+		}
+
+		inline uint32_t YUVToARGB(int y, int u, int v){
+			const auto luma = (y - 16) * 74;
+			u -= 128;
+			v -= 128;
+			const auto r = ClampShift(luma + v * 102);
+			const auto g = ClampShift(luma - u * 25 - v * 52);
+			const auto b = ClampShift(luma + u * 129);
+			return 0xFF000000u | static_cast<uint32_t>(r) << 16 | static_cast<uint32_t>(g) << 8 | b;
+		}
+
+		void YUVRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uvStep, uint32_t* dst, int width){
+			for(auto i = 0; i < width; ++i){
+				const auto c = i / 2 * uvStep;
+				dst[i] = YUVToARGB(y[i], u[c], v[c]);
+			}
+		}
+
+#ifdef SDL2PP_PIXELCONVERT_SSE2
+		void Expand565SSE2(const uint16_t* src, uint32_t* dst, int width){
+			const auto mask5 = _mm_set1_epi16(0x1F);
+			const auto mask6 = _mm_set1_epi16(0x3F);
+			const auto alpha = _mm_set1_epi16(static_cast<short>(0xFF00));
+			auto i = 0;
+			for(; i + 8 <= width; i += 8){
+				const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+				const auto r5 = _mm_srli_epi16(in, 11);
+				const auto g6 = _mm_and_si128(_mm_srli_epi16(in, 5), mask6);
+				const auto b5 = _mm_and_si128(in, mask5);
+				const auto r = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+				const auto g = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+				const auto b = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+				// B | G << 8 and R | A << 8, interleaved into B G R A.
+				const auto bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+				const auto ra = _mm_or_si128(r, alpha);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(bg, ra));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(bg, ra));
+			}
+			Expand565Scalar(src + i, dst + i, width - i);
+		}
+
+		inline __m128i Pack565Quad(__m128i pixels){
+			const auto r = _mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32(0xF800));
+			const auto g = _mm_and_si128(_mm_srli_epi32(pixels, 5), _mm_set1_epi32(0x07E0));
+			const auto b = _mm_and_si128(_mm_srli_epi32(pixels, 3), _mm_set1_epi32(0x001F));
+			// Sign extend so the signed pack keeps all 16 bits.
+			return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(_mm_or_si128(r, g), b), 16), 16);
+		}
+
+		void Pack565SSE2(const uint32_t* src, uint16_t* dst, int width){
+			auto i = 0;
+			for(; i + 8 <= width; i += 8){
+				const auto lo = Pack565Quad(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+				const auto hi = Pack565Quad(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+			}
+			Pack565Scalar(src + i, dst + i, width - i);
+		}
+
+		void YUVRowSSE2(const uint8_t* y, const uint8_t* u, const uint8_t* v, int uvStep, uint32_t* dst, int width){
+			const auto zero = _mm_setzero_si128();
+			const auto lowByte = _mm_set1_epi16(0xFF);
+			const auto offset16 = _mm_set1_epi16(16);
+			const auto offset128 = _mm_set1_epi16(128);
+			const auto round = _mm_set1_epi16(32);
+			const auto alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+			// Interleaved chroma reads one byte past the pair it needs.
+			const auto end = uvStep == 2 ? width - 8 : width - 7;
+			auto i = 0;
+			for(; i < end; i += 8){
+				const auto luma = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + i)), zero);
+				__m128i cu, cv;
+				if(uvStep == 2){
+					cu = _mm_and_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + i)), lowByte);
+					cv = _mm_and_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + i)), lowByte);
+				}else{
+					int32_t u4, v4;
+					std::memcpy(&u4, u + i / 2, 4);
+					std::memcpy(&v4, v + i / 2, 4);
+					cu = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero);
+					cv = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero);
+				}
+				// One chroma sample per two pixels.
+				cu = _mm_sub_epi16(_mm_unpacklo_epi16(cu, cu), offset128);
+				cv = _mm_sub_epi16(_mm_unpacklo_epi16(cv, cv), offset128);
+				const auto yy = _mm_mullo_epi16(_mm_sub_epi16(luma, offset16), _mm_set1_epi16(74));
+
+				auto r = _mm_adds_epi16(yy, _mm_mullo_epi16(cv, _mm_set1_epi16(102)));
+				auto g = _mm_sub_epi16(_mm_sub_epi16(yy, _mm_mullo_epi16(cu, _mm_set1_epi16(25))), _mm_mullo_epi16(cv, _mm_set1_epi16(52)));
+				auto b = _mm_adds_epi16(yy, _mm_mullo_epi16(cu, _mm_set1_epi16(129)));
+				r = _mm_srai_epi16(_mm_adds_epi16(r, round), 6);
+				g = _mm_srai_epi16(_mm_adds_epi16(g, round), 6);
+				b = _mm_srai_epi16(_mm_adds_epi16(b, round), 6);
+
+				const auto bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+				const auto ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), alpha);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(bg, ra));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(bg, ra));
+			}
+			YUVRowScalar(y + i, u + i / 2 * uvStep, v + i / 2 * uvStep, uvStep, dst + i, width - i);
+		}
+#endif
+
+#ifdef SDL2PP_PIXELCONVERT_SSSE3
+		// Four pixels per step. Exactly four destination pixels are stored,
+		// so converting in place never overwrites unread source bytes.
+		__attribute__((target("ssse3")))
+		void ShuffleSSSE3(const uint8_t* src, uint8_t* dst, int width, const PixelConvert::Shuffle& shuffle){
+			const auto mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.mask));
+			const auto fill = _mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.fill));
+			const auto srcBytes = shuffle.srcBytes;
+			const auto dstBytes = shuffle.dstBytes;
+			auto i = 0;
+			// The load takes 16 bytes even for 3-byte pixels.
+			for(; (width - i) * srcBytes >= 16; i += 4){
+				const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * srcBytes));
+				const auto out = _mm_or_si128(_mm_shuffle_epi8(in, mask), fill);
+				auto* p = dst + i * dstBytes;
+				if(dstBytes == 4){
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(p), out);
+				}else{
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(p), out);
+					const auto tail = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+					std::memcpy(p + 8, &tail, 4);
+				}
+			}
+			ShuffleScalar(src + i * srcBytes, dst + i * dstBytes, width - i, shuffle);
+		}
+
+		__attribute__((target("avx2")))
+		void Shuffle32AVX2(const uint8_t* src, uint8_t* dst, int width, const PixelConvert::Shuffle& shuffle){
+			// pshufb works per 128-bit lane, which holds four pixels.
+			const auto mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.mask)));
+			const auto fill = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(shuffle.fill)));
+			auto i = 0;
+			for(; i + 8 <= width; i += 8){
+				const auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(in, mask), fill));
+			}
+			ShuffleSSSE3(src + i * 4, dst + i * 4, width - i, shuffle);
+		}
+#endif
+
+		struct Kernels{
+			const char* name;
+			ShuffleFunc shuffle;
+			// 4-byte to 4-byte formats.
+			ShuffleFunc shuffle32;
+			Expand565Func expand565;
+			Pack565Func pack565;
+			YUVRowFunc yuvRow;
+		};
+
+		Kernels ScalarKernels(){
+			return Kernels{"scalar", ShuffleScalar, ShuffleScalar, Expand565Scalar, Pack565Scalar, YUVRowScalar};
+		}
+
+		Kernels SelectKernels(){
+#ifdef SDL2PP_PIXELCONVERT_SSSE3
+			// SDL has no SSSE3 check; every CPU with SSE4.1 has it.
+			if(SDL_HasSSE41()){
+				if(SDL_HasAVX2())
+					return Kernels{"avx2", ShuffleSSSE3, Shuffle32AVX2, Expand565SSE2, Pack565SSE2, YUVRowSSE2};
+				return Kernels{"ssse3", ShuffleSSSE3, ShuffleSSSE3, Expand565SSE2, Pack565SSE2, YUVRowSSE2};
+			}
+#endif
+#ifdef SDL2PP_PIXELCONVERT_SSE2
+			return Kernels{"sse2", ShuffleScalar, ShuffleScalar, Expand565SSE2, Pack565SSE2, YUVRowSSE2};
+#else
+			return ScalarKernels();
+#endif
+		}
+
+		std::atomic<bool> forceScalar(false);
+
+		const Kernels& GetKernels(){
+			static const Kernels kernels = SelectKernels();
+			static const Kernels scalar = ScalarKernels();
+			return forceScalar.load(std::memory_order_relaxed) ? scalar : kernels;
+		}
+
+		bool IsYUV(uint32_t format){
+			return format == SDL_PIXELFORMAT_IYUV || format == SDL_PIXELFORMAT_YV12
+				|| format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21;
+		}
+
+		bool IsInterleavedYUV(uint32_t format){
+			return format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21;
+		}
+
+	}
+
+	bool PixelConvert::Supports(uint32_t srcFormat, uint32_t dstFormat){
+		return FindLayout(srcFormat) != nullptr && FindLayout(dstFormat) != nullptr;
+	}
+
+	const char* PixelConvert::GetKernelName(){
+		return GetKernels().name;
+	}
+
+	void PixelConvert::ForceScalarKernels(bool force){
+		forceScalar = force;
+	}
+
+	PixelConvert::PixelConvert(uint32_t srcFormat, uint32_t dstFormat):m_srcFormat(srcFormat), m_dstFormat(dstFormat){
+		const auto* src = FindLayout(srcFormat);
+		const auto* dst = FindLayout(dstFormat);
+		if(src == nullptr || dst == nullptr)
+			throw std::invalid_argument("PixelConvert: unsupported format pair");
+		m_srcBytes = src->bytes;
+		m_dstBytes = dst->bytes;
+
+		const auto* argb = FindLayout(SDL_PIXELFORMAT_ARGB8888);
+		if(srcFormat == dstFormat){
+			m_kind = Kind::Copy;
+		}else if(srcFormat == SDL_PIXELFORMAT_RGB565){
+			m_kind = Kind::From565;
+			m_shuffle = MakeShuffle(*argb, *dst);
+		}else if(dstFormat == SDL_PIXELFORMAT_RGB565){
+			m_kind = Kind::To565;
+			m_shuffle = MakeShuffle(*src, *argb);
+		}else{
+			m_kind = Kind::Shuffle;
+			m_shuffle = MakeShuffle(*src, *dst);
+		}
+	}
+
+	void PixelConvert::ConvertRow(const void* src, void* dst, int width) const{
+		const auto& kernels = GetKernels();
+		const auto* in = static_cast<const uint8_t*>(src);
+		auto* out = static_cast<uint8_t*>(dst);
+		switch(m_kind){
+			case Kind::Copy:
+				if(in != out)
+					std::memmove(out, in, static_cast<std::size_t>(width) * m_srcBytes);
+				break;
+			case Kind::Shuffle:
+				(m_srcBytes == 4 && m_dstBytes == 4 ? kernels.shuffle32 : kernels.shuffle)(in, out, width, m_shuffle);
+				break;
+			case Kind::From565:
+				if(m_dstFormat == SDL_PIXELFORMAT_ARGB8888){
+					kernels.expand565(reinterpret_cast<const uint16_t*>(in), reinterpret_cast<uint32_t*>(out), width);
+					break;
+				}
+				for(auto i = 0; i < width; i += ChunkSize){
+					uint32_t argb[ChunkSize];
+					const auto count = std::min(ChunkSize, width - i);
+					kernels.expand565(reinterpret_cast<const uint16_t*>(in) + i, argb, count);
+					(m_dstBytes == 4 ? kernels.shuffle32 : kernels.shuffle)(reinterpret_cast<const uint8_t*>(argb), out + i * m_dstBytes, count, m_shuffle);
+				}
+				break;
+			case Kind::To565:
+				if(m_srcFormat == SDL_PIXELFORMAT_ARGB8888){
+					kernels.pack565(reinterpret_cast<const uint32_t*>(in), reinterpret_cast<uint16_t*>(out), width);
+					break;
+				}
+				for(auto i = 0; i < width; i += ChunkSize){
+					uint32_t argb[ChunkSize];
+					const auto count = std::min(ChunkSize, width - i);
+					(m_srcBytes == 4 ? kernels.shuffle32 : kernels.shuffle)(in + i * m_srcBytes, reinterpret_cast<uint8_t*>(argb), count, m_shuffle);
+					kernels.pack565(argb, reinterpret_cast<uint16_t*>(out) + i, count);
+				}
+				break;
+		}
+	}
+
+	void PixelConvert::Convert(int w, int h, const void* src, int srcPitch, void* dst, int dstPitch) const{
+		const auto* in = static_cast<const uint8_t*>(src);
+		auto* out = static_cast<uint8_t*>(dst);
+		for(auto y = 0; y < h; ++y)
+			ConvertRow(in + y * srcPitch, out + y * dstPitch, w);
+	}
+
+	void PixelConvert::Convert(int w, int h, uint32_t srcFormat, const void* src, int srcPitch, uint32_t dstFormat, void* dst, int dstPitch){
+		if(Supports(srcFormat, dstFormat)){
+			PixelConvert(srcFormat, dstFormat).Convert(w, h, src, srcPitch, dst, dstPitch);
+			return;
+		}
+		if(SDL_ConvertPixels(w, h, srcFormat, src, srcPitch, dstFormat, dst, dstPitch) != 0)
+			throw Error();
+	}
+
+	void PixelConvert::ConvertYUVToRGB(int w, int h, uint32_t yuvFormat,
+	                                   const uint8_t* yPlane, int yPitch,
+	                                   const uint8_t* uPlane, int uPitch,
+	                                   const uint8_t* vPlane, int vPitch,
+	                                   uint32_t dstFormat, void* dst, int dstPitch){
+		if(!IsYUV(yuvFormat) || FindLayout(dstFormat) == nullptr)
+			throw std::invalid_argument("PixelConvert: unsupported format pair");
+		auto uvStep = 1;
+		if(IsInterleavedYUV(yuvFormat)){
+			// Both point into the interleaved plane, V after U for NV12.
+			uvStep = 2;
+			vPitch = uPitch;
+			vPlane = yuvFormat == SDL_PIXELFORMAT_NV12 ? uPlane + 1 : uPlane;
+			uPlane = yuvFormat == SDL_PIXELFORMAT_NV12 ? uPlane : uPlane + 1;
+		}
+
+		const auto yuvRow = GetKernels().yuvRow;
+		const PixelConvert fromARGB(SDL_PIXELFORMAT_ARGB8888, dstFormat);
+		const auto direct = FindLayout(dstFormat)->bytes == 4;
+		std::vector<uint32_t> row(direct ? 0 : w);
+		auto* out = static_cast<uint8_t*>(dst);
+		for(auto y = 0; y < h; ++y){
+			auto* line = direct ? reinterpret_cast<uint32_t*>(out + y * dstPitch) : row.data();
+			yuvRow(yPlane + y * yPitch, uPlane + y / 2 * uPitch, vPlane + y / 2 * vPitch, uvStep, line, w);
+			fromARGB.ConvertRow(line, out + y * dstPitch, w);
+		}
+	}
+
+	void PixelConvert::ConvertRGBToYUV(int w, int h, uint32_t srcFormat, const void* src, int srcPitch,
+	                                   uint32_t yuvFormat,
+	                                   uint8_t* yPlane, int yPitch,
+	                                   uint8_t* uPlane, int uPitch,
+	                                   uint8_t* vPlane, int vPitch){
+		if(!IsYUV(yuvFormat) || FindLayout(srcFormat) == nullptr)
+			throw std::invalid_argument("PixelConvert: unsupported format pair");
+		auto uvStep = 1;
+		if(IsInterleavedYUV(yuvFormat)){
+			uvStep = 2;
+			vPitch = uPitch;
+			vPlane = yuvFormat == SDL_PIXELFORMAT_NV12 ? uPlane + 1 : uPlane;
+			uPlane = yuvFormat == SDL_PIXELFORMAT_NV12 ? uPlane : uPlane + 1;
+		}
+
+		const PixelConvert toARGB(srcFormat, SDL_PIXELFORMAT_ARGB8888);
+		const auto* in = static_cast<const uint8_t*>(src);
+		std::vector<uint32_t> rows(static_cast<std::size_t>(w) * 2);
+		for(auto y = 0; y < h; y += 2){
+			// An odd last row pairs with itself.
+			const auto rowCount = std::min(2, h - y);
+			for(auto r = 0; r < rowCount; ++r){
+				auto* argb = rows.data() + r * w;
+				toARGB.ConvertRow(in + (y + r) * srcPitch, argb, w);
+				auto* luma = yPlane + (y + r) * yPitch;
+				for(auto x = 0; x < w; ++x){
+					const auto p = argb[x];
+					const int R = (p >> 16) & 0xFF, G = (p >> 8) & 0xFF, B = p & 0xFF;
+					luma[x] = static_cast<uint8_t>(((66 * R + 129 * G + 25 * B + 128) >> 8) + 16);
+				}
+			}
+			const auto* top = rows.data();
+			const auto* bottom = rows.data() + (rowCount - 1) * w;
+			auto* u = uPlane + y / 2 * uPitch;
+			auto* v = vPlane + y / 2 * vPitch;
+			for(auto x = 0; x < w; x += 2){
+				const auto x1 = std::min(x + 1, w - 1);
+				const uint32_t quad[4] = {top[x], top[x1], bottom[x], bottom[x1]};
+				int R = 0, G = 0, B = 0;
+				for(auto p : quad){
+					R += (p >> 16) & 0xFF;
+					G += (p >> 8) & 0xFF;
+					B += p & 0xFF;
+				}
+				R = (R + 2) >> 2;
+				G = (G + 2) >> 2;
+				B = (B + 2) >> 2;
+				u[x / 2 * uvStep] = static_cast<uint8_t>(((-38 * R - 74 * G + 112 * B + 128) >> 8) + 128);
+				v[x / 2 * uvStep] = static_cast<uint8_t>(((112 * R - 94 * G - 18 * B + 128) >> 8) + 128);
+			}
+		}
+	}
+
+}
@@ -0,0 +1,218 @@
+#include "polylinereducer.h"
+#include "profiler.h"
+#include "renderer.h"
+#include <algorithm>
+#include <climits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SDL2PP_POLYLINEREDUCER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace SDL{
+
+	namespace{
+
+		// Cohen-Sutherland outcodes; only "inside" and "both ends beyond the
+		// same edge" are tested, SDL clips the rest.
+		const uint8_t OutLeft = 1;
+		const uint8_t OutRight = 2;
+		const uint8_t OutTop = 4;
+		const uint8_t OutBottom = 8;
+
+		inline uint8_t OutCode(const Point& point, const Rect& clip){
+			return static_cast<uint8_t>((point.x < clip.x ? OutLeft : 0) | (point.x >= clip.x + clip.w ? OutRight : 0)
+				| (point.y < clip.y ? OutTop : 0) | (point.y >= clip.y + clip.h ? OutBottom : 0));
+		}
+
+#ifdef SDL2PP_POLYLINEREDUCER_SSE2
+		// SSE2 has no 32-bit min and max.
+		inline __m128i MinSSE2(__m128i a, __m128i b){
+			const auto greater = _mm_cmpgt_epi32(a, b);
+			return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+		}
+
+		inline __m128i MaxSSE2(__m128i a, __m128i b){
+			const auto greater = _mm_cmpgt_epi32(a, b);
+			return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+		}
+#endif
+
+		void ComputeOutCodes(const Point* points, std::size_t count, const Rect& clip, uint8_t* codes){
+			std::size_t i = 0;
+#ifdef SDL2PP_POLYLINEREDUCER_SSE2
+			// Two points per register: x0, y0, x1, y1.
+			const auto low = _mm_setr_epi32(clip.x, clip.y, clip.x, clip.y);
+			const auto high = _mm_setr_epi32(clip.x + clip.w - 1, clip.y + clip.h - 1, clip.x + clip.w - 1, clip.y + clip.h - 1);
+			for(; i + 2 <= count; i += 2){
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(points + i));
+				const auto below = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, low)));
+				const auto above = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, high)));
+				codes[i] = static_cast<uint8_t>((below & 1) | (above & 1) << 1 | (below & 2) << 1 | (above & 2) << 2);
+				codes[i + 1] = static_cast<uint8_t>((below & 4) >> 2 | (above & 4) >> 1 | (below & 8) >> 1 | (above & 8));
+			}
+#endif
+			for(; i < count; ++i)
+				codes[i] = OutCode(points[i], clip);
+		}
+
+		// Finds the end of the points from first on that lie in column x and
+		// widens minY and maxY by them.
+		std::size_t ScanColumn(const Point* points, std::size_t first, std::size_t last, int x, int& minY, int& maxY){
+			auto i = first;
+#ifdef SDL2PP_POLYLINEREDUCER_SSE2
+			const auto column = _mm_set1_epi32(x);
+			auto low = _mm_set1_epi32(INT_MAX), high = _mm_set1_epi32(INT_MIN);
+			for(; i + 2 <= last; i += 2){
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(points + i));
+				if((_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, column))) & 5) != 5)
+					break;
+				low = MinSSE2(low, v);
+				high = MaxSSE2(high, v);
+			}
+			// The y values are in lanes 1 and 3.
+			alignas(16) int lows[4], highs[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lows), low);
+			_mm_store_si128(reinterpret_cast<__m128i*>(highs), high);
+			minY = std::min(minY, std::min(lows[1], lows[3]));
+			maxY = std::max(maxY, std::max(highs[1], highs[3]));
+#endif
+			for(; i < last && points[i].x == x; ++i){
+				minY = std::min(minY, points[i].y);
+				maxY = std::max(maxY, points[i].y);
+			}
+			return i;
+		}
+
+	}
+
+	Span<const Point> PolylineReducer::GetRun(std::size_t index) const{
+		const auto first = index == 0 ? 0 : m_runEnds[index - 1];
+		return Span<const Point>(m_points.data() + first, m_runEnds[index] - first);
+	}
+
+	void PolylineReducer::Reduce(Span<const Point> points, const Rect& clip){
+		SDL2PP_PROFILE_ZONE(ReducePolyline);
+		m_points.clear();
+		m_runEnds.clear();
+		m_runOpen = false;
+		m_columnOpen = false;
+		const auto count = points.size();
+		if(count < 2 || clip.w <= 0 || clip.h <= 0)
+			return;
+
+		m_codes.resize(count);
+		ComputeOutCodes(points.data(), count, clip, m_codes.data());
+		const auto* codes = m_codes.data();
+		for(std::size_t i = 0; i + 1 < count;){
+			const auto startCode = codes[i], endCode = codes[i + 1];
+			if((startCode | endCode) == 0){
+				// Take the whole stretch of points inside at once.
+				auto last = i + 2;
+				while(last < count && codes[last] == 0)
+					++last;
+				if(!m_runOpen){
+					BeginRun();
+					AddPoints(points.data(), i, last);
+				}else
+					AddPoints(points.data(), i + 1, last);
+				i = last - 1;
+				continue;
+			}
+
+			const auto& start = points[i];
+			const auto& end = points[i + 1];
+			++i;
+			if((startCode & endCode) != 0){
+				EndRun();
+				continue;
+			}
+			auto x1 = start.x, y1 = start.y, x2 = end.x, y2 = end.y;
+			if(!SDL_IntersectRectAndLine(&clip, &x1, &y1, &x2, &y2)){
+				EndRun();
+				continue;
+			}
+			if(startCode != 0 || !m_runOpen){
+				EndRun();
+				BeginRun();
+				AddPoint(Point{x1, y1});
+			}
+			AddPoint(Point{x2, y2});
+			if(endCode != 0)
+				EndRun();
+		}
+		EndRun();
+	}
+
+	std::size_t PolylineReducer::DrawLines(Renderer& renderer, Span<const Point> points){
+		Reduce(points, renderer.RenderGetVisibleRect());
+		for(std::size_t run = 0; run < GetRunCount(); ++run)
+			renderer.RenderDrawLines(GetRun(run));
+		return GetSize();
+	}
+
+	void PolylineReducer::BeginRun(){
+		m_runStart = m_points.size();
+		m_runOpen = true;
+	}
+
+	void PolylineReducer::EndRun(){
+		if(!m_runOpen)
+			return;
+		FlushColumn();
+		m_runOpen = false;
+		// A line that collapsed to one point still draws its pixel.
+		if(m_points.size() - m_runStart == 1)
+			m_points.push_back(m_points.back());
+		m_runEnds.push_back(m_points.size());
+	}
+
+	void PolylineReducer::AddPoints(const Point* points, std::size_t first, std::size_t last){
+		while(first < last){
+			const auto x = points[first].x;
+			auto minY = INT_MAX, maxY = INT_MIN;
+			const auto end = ScanColumn(points, first, last, x, minY, maxY);
+			// Only the order of the first extreme matters.
+			auto k = first;
+			while(points[k].y != minY && points[k].y != maxY)
+				++k;
+			AddColumn(Column{x, points[first].y, minY, maxY, points[end - 1].y, points[k].y == minY});
+			first = end;
+		}
+	}
+
+	void PolylineReducer::AddColumn(const Column& column){
+		if(!m_columnOpen || column.x != m_column.x){
+			FlushColumn();
+			m_column = column;
+			m_columnOpen = true;
+			return;
+		}
+		// The new part comes after the current one.
+		const auto newMin = column.minY < m_column.minY;
+		const auto newMax = column.maxY > m_column.maxY;
+		if(newMin && newMax)
+			m_column.minFirst = column.minFirst;
+		else if(newMin)
+			m_column.minFirst = false;
+		else if(newMax)
+			m_column.minFirst = true;
+		m_column.minY = std::min(m_column.minY, column.minY);
+		m_column.maxY = std::max(m_column.maxY, column.maxY);
+		m_column.lastY = column.lastY;
+	}
+
+	void PolylineReducer::FlushColumn(){
+		if(!m_columnOpen)
+			return;
+		m_columnOpen = false;
+		const auto& column = m_column;
+		const int ys[] = {column.firstY, column.minFirst ? column.minY : column.maxY, column.minFirst ? column.maxY : column.minY, column.lastY};
+		m_points.push_back(Point{column.x, ys[0]});
+		for(auto i = 1; i < 4; ++i){
+			if(ys[i] != ys[i - 1])
+				m_points.push_back(Point{column.x, ys[i]});
+		}
+	}
+
+}
@@ -0,0 +1,149 @@
+#include "profiler.h"
+#include <SDL_timer.h>
+#include <algorithm>
+#include <fstream>
+#include <ostream>
+
+namespace SDL{
+
+	static const char* const zoneNames[] = {
+		"Frame",
+		"RenderPresent",
+		"EventDispatch",
+		"RenderClear",
+		"RenderDrawPoint",
+		"RenderDrawPoints",
+		"RenderDrawLine",
+		"RenderDrawLines",
+		"RenderDrawRect",
+		"RenderDrawRects",
+		"RenderFillRect",
+		"RenderFillRects",
+		"RenderCopy",
+		"RenderReadPixels",
+		"SetRenderDrawColor",
+		"SetRenderState",
+		"FlushCommandBuffer",
+		"SubmitCommandLists",
+		"CreateTexture",
+		"UpdateTexture",
+		"LockTexture",
+		"DecodeImage",
+		"ReducePolyline"
+	};
+
+	static_assert(sizeof(zoneNames) / sizeof(zoneNames[0]) == static_cast<std::size_t>(Profiler::Zone::Count), "zone name missing");
+
+	Profiler& Profiler::Get(){
+		static Profiler profiler;
+		return profiler;
+	}
+
+	Profiler::Profiler():m_frequency(SDL_GetPerformanceFrequency()), m_frameBegin(Now()){
+
+	}
+
+	const char* Profiler::GetZoneName(Zone zone){
+		return zoneNames[static_cast<std::size_t>(zone)];
+	}
+
+	uint64_t Profiler::Now(){
+		return SDL_GetPerformanceCounter();
+	}
+
+	double Profiler::ToMilliseconds(uint64_t ticks) const{
+		return ticks * 1000.0 / m_frequency;
+	}
+
+	void Profiler::Record(Zone zone, uint64_t begin, uint64_t end){
+		auto& stats = m_current[static_cast<std::size_t>(zone)];
+		++stats.calls;
+		stats.ticks += end - begin;
+		if(m_tracing && m_events.size() < m_maxEvents)
+			m_events.push_back(TraceEvent{zone, begin, end});
+	}
+
+	void Profiler::EndFrame(){
+		const auto now = Now();
+		Record(Zone::Frame, m_frameBegin, now);
+		m_history[m_frames % HistoryLength] = m_current;
+		++m_frames;
+		m_current = FrameStats{};
+		m_frameBegin = now;
+	}
+
+	const Profiler::ZoneStats& Profiler::GetLastFrame(Zone zone) const{
+		static const ZoneStats empty;
+		if(m_frames == 0)
+			return empty;
+		return m_history[(m_frames - 1) % HistoryLength][static_cast<std::size_t>(zone)];
+	}
+
+	std::size_t Profiler::GetHistorySize() const{
+		return std::min(m_frames, HistoryLength);
+	}
+
+	std::vector<uint32_t> Profiler::GetHistogram(Zone zone, double bucketMs, std::size_t bucketCount) const{
+		std::vector<uint32_t> buckets(bucketCount, 0);
+		if(bucketCount == 0 || bucketMs <= 0.0)
+			return buckets;
+		for(std::size_t i = 0; i < GetHistorySize(); ++i){
+			const auto ms = ToMilliseconds(m_history[i][static_cast<std::size_t>(zone)].ticks);
+			const auto bucket = std::min(static_cast<std::size_t>(ms / bucketMs), bucketCount - 1);
+			++buckets[bucket];
+		}
+		return buckets;
+	}
+
+	double Profiler::GetPercentile(Zone zone, double percentile) const{
+		const auto frames = GetHistorySize();
+		if(frames == 0)
+			return 0.0;
+		std::vector<uint64_t> ticks(frames);
+		for(std::size_t i = 0; i < frames; ++i)
+			ticks[i] = m_history[i][static_cast<std::size_t>(zone)].ticks;
+		const auto rank = std::min(static_cast<std::size_t>(percentile / 100.0 * frames), frames - 1);
+		std::nth_element(ticks.begin(), ticks.begin() + rank, ticks.end());
+		return ToMilliseconds(ticks[rank]);
+	}
+
+	void Profiler::StartTrace(std::size_t maxEvents){
+		m_events.clear();
+		m_events.reserve(maxEvents);
+		m_maxEvents = maxEvents;
+		m_tracing = true;
+	}
+
+	void Profiler::StopTrace(){
+		m_tracing = false;
+	}
+
+	void Profiler::WriteChromeTrace(std::ostream& stream) const{
+		const auto flags = stream.flags();
+		stream.setf(std::ios::fixed);
+		const auto precision = stream.precision(3);
+
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		auto first = true;
+		for(const auto& event : m_events){
+			stream << (first ? "\n" : ",\n")
+				<< "{\"name\":\"" << GetZoneName(event.zone) << "\",\"cat\":\"SDL2++\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+				<< ",\"ts\":" << event.begin * 1000000.0 / m_frequency
+				<< ",\"dur\":" << (event.end - event.begin) * 1000000.0 / m_frequency << "}";
+			first = false;
+		}
+		stream << "\n]}\n";
+
+		stream.precision(precision);
+		stream.flags(flags);
+	}
+
+	bool Profiler::WriteChromeTrace(const std::string& path) const{
+		std::ofstream file(path);
+		if(!file)
+			return false;
+		WriteChromeTrace(file);
+		return static_cast<bool>(file);
+	}
+
+}
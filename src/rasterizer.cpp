@@ -0,0 +1,507 @@
+#include "rasterizer.h"
+#include <SDL_cpuinfo.h>
+#include <SDL_hints.h>
+#include <SDL_surface.h>
+#include <SDL_version.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SDL2PP_RASTERIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SDL2PP_RASTERIZER_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SDL2PP_RASTERIZER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace SDL{
+
+	namespace{
+
+		typedef void (*FillSpanFunc)(uint32_t* pixels, int count, uint32_t pixel);
+		typedef void (*BlendSpanFunc)(uint32_t* pixels, int count, const uint8_t* mul, const uint8_t* add);
+
+		// SDL's DRAW_MUL rounding, followed by a saturating add.
+		inline uint32_t BlendPixel(uint32_t pixel, const uint8_t* mul, const uint8_t* add){
+			uint32_t result = 0;
+			for(auto i = 0; i < 4; ++i){
+				const auto value = ((pixel >> (8 * i)) & 0xFF) * mul[i] / 255 + add[i];
+				result |= std::min(value, 255u) << (8 * i);
+			}
+			return result;
+		}
+
+		void BlendSpanScalar(uint32_t* pixels, int count, const uint8_t* mul, const uint8_t* add){
+			for(auto i = 0; i < count; ++i)
+				pixels[i] = BlendPixel(pixels[i], mul, add);
+		}
+
+#ifndef SDL2PP_RASTERIZER_SSE2
+		void FillSpanScalar(uint32_t* pixels, int count, uint32_t pixel){
+			std::fill(pixels, pixels + count, pixel);
+		}
+#else
+		void FillSpanSSE2(uint32_t* pixels, int count, uint32_t pixel){
+			const auto value = _mm_set1_epi32(static_cast<int>(pixel));
+			auto i = 0;
+			for(; i + 4 <= count; i += 4)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), value);
+			for(; i < count; ++i)
+				pixels[i] = pixel;
+		}
+
+		// x / 255 for x <= 255 * 255, exact: (x + 1 + (x >> 8)) >> 8.
+		inline __m128i BlendHalfSSE2(__m128i pixels, __m128i mul, __m128i add, __m128i one){
+			const auto product = _mm_mullo_epi16(pixels, mul);
+			const auto quotient = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(product, one), _mm_srli_epi16(product, 8)), 8);
+			return _mm_add_epi16(quotient, add);
+		}
+
+		void BlendSpanSSE2(uint32_t* pixels, int count, const uint8_t* mul, const uint8_t* add){
+			const auto zero = _mm_setzero_si128();
+			const auto one = _mm_set1_epi16(1);
+			// Two pixels per half, so the four byte factors repeat once.
+			const auto mul16 = _mm_setr_epi16(mul[0], mul[1], mul[2], mul[3], mul[0], mul[1], mul[2], mul[3]);
+			const auto add16 = _mm_setr_epi16(add[0], add[1], add[2], add[3], add[0], add[1], add[2], add[3]);
+			auto i = 0;
+			for(; i + 4 <= count; i += 4){
+				auto* p = reinterpret_cast<__m128i*>(pixels + i);
+				const auto in = _mm_loadu_si128(p);
+				const auto lo = BlendHalfSSE2(_mm_unpacklo_epi8(in, zero), mul16, add16, one);
+				const auto hi = BlendHalfSSE2(_mm_unpackhi_epi8(in, zero), mul16, add16, one);
+				_mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+			}
+			BlendSpanScalar(pixels + i, count - i, mul, add);
+		}
+#endif
+
+#ifdef SDL2PP_RASTERIZER_AVX2
+		__attribute__((target("avx2")))
+		void BlendSpanAVX2(uint32_t* pixels, int count, const uint8_t* mul, const uint8_t* add){
+			const auto zero = _mm256_setzero_si256();
+			const auto one = _mm256_set1_epi16(1);
+			const auto mul16 = _mm256_setr_epi16(mul[0], mul[1], mul[2], mul[3], mul[0], mul[1], mul[2], mul[3],
+				mul[0], mul[1], mul[2], mul[3], mul[0], mul[1], mul[2], mul[3]);
+			const auto add16 = _mm256_setr_epi16(add[0], add[1], add[2], add[3], add[0], add[1], add[2], add[3],
+				add[0], add[1], add[2], add[3], add[0], add[1], add[2], add[3]);
+			auto i = 0;
+			for(; i + 8 <= count; i += 8){
+				auto* p = reinterpret_cast<__m256i*>(pixels + i);
+				const auto in = _mm256_loadu_si256(p);
+				auto lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(in, zero), mul16);
+				auto hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(in, zero), mul16);
+				lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+				hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+				// Unpack and pack both work per 128-bit lane, the pixel order is kept.
+				_mm256_storeu_si256(p, _mm256_packus_epi16(_mm256_add_epi16(lo, add16), _mm256_add_epi16(hi, add16)));
+			}
+			BlendSpanSSE2(pixels + i, count - i, mul, add);
+		}
+#endif
+
+		struct Kernels{
+			const char* name;
+			FillSpanFunc fill;
+			BlendSpanFunc blend;
+		};
+
+		Kernels SelectKernels(){
+#ifdef SDL2PP_RASTERIZER_AVX2
+			if(SDL_HasAVX2())
+				return Kernels{"avx2", FillSpanSSE2, BlendSpanAVX2};
+#endif
+#ifdef SDL2PP_RASTERIZER_SSE2
+			return Kernels{"sse2", FillSpanSSE2, BlendSpanSSE2};
+#else
+			return Kernels{"scalar", FillSpanScalar, BlendSpanScalar};
+#endif
+		}
+
+		const Kernels& GetKernels(){
+			static const Kernels kernels = SelectKernels();
+			return kernels;
+		}
+
+		class SurfaceLock{
+			public:
+				SurfaceLock(SDL_Surface* surface):m_surface(SDL_MUSTLOCK(surface) ? surface : nullptr){
+					if(m_surface != nullptr && SDL_LockSurface(m_surface) != 0){
+						m_surface = nullptr;
+						m_result = -1;
+					}
+				}
+				~SurfaceLock(){
+					if(m_surface != nullptr)
+						SDL_UnlockSurface(m_surface);
+				}
+
+				SurfaceLock(const SurfaceLock&) = delete;
+				SurfaceLock& operator=(const SurfaceLock&) = delete;
+
+				int GetResult() const{ return m_result; }
+
+			private:
+				SDL_Surface* m_surface;
+				int m_result = 0;
+		};
+
+		bool IsByteMask(uint32_t mask, uint8_t shift){
+			return shift % 8 == 0 && mask == 0xFFu << shift;
+		}
+
+	}
+
+	bool SurfaceRasterizer::Supports(const SDL_Surface* surface){
+		if(surface == nullptr || surface->format == nullptr)
+			return false;
+		const auto* format = surface->format;
+		return format->BytesPerPixel == 4
+			&& IsByteMask(format->Rmask, format->Rshift)
+			&& IsByteMask(format->Gmask, format->Gshift)
+			&& IsByteMask(format->Bmask, format->Bshift)
+			&& (format->Amask == 0 || IsByteMask(format->Amask, format->Ashift));
+	}
+
+	bool SurfaceRasterizer::SupportsBlendMode(SDL_BlendMode blendMode){
+		return blendMode == SDL_BLENDMODE_NONE || blendMode == SDL_BLENDMODE_BLEND
+			|| blendMode == SDL_BLENDMODE_ADD || blendMode == SDL_BLENDMODE_MOD;
+	}
+
+	bool SurfaceRasterizer::SupportsLines(){
+		// DrawLine() follows SDL 2.0.20 and later, which step lines as points
+		// after cutting them to the viewport size. Earlier versions cut them
+		// to the clip rect, which moves the pixels of clipped lines, and the
+		// other line methods leave lines to the backend.
+		SDL_version version;
+		SDL_GetVersion(&version);
+		if(SDL_VERSIONNUM(version.major, version.minor, version.patch) < SDL_VERSIONNUM(2, 0, 20))
+			return false;
+		const auto* method = SDL_GetHint("SDL_RENDER_LINE_METHOD");
+		return method == nullptr || std::strcmp(method, "0") == 0 || std::strcmp(method, "1") == 0;
+	}
+
+	const char* SurfaceRasterizer::GetKernelName(){
+		return GetKernels().name;
+	}
+
+	SurfaceRasterizer::SurfaceRasterizer(SDL_Surface* surface):m_surface(surface){
+		if(!Supports(surface))
+			throw std::invalid_argument("SurfaceRasterizer: surface is not 32-bit with 8-bit channels");
+		m_bounds = Rect{0, 0, surface->w, surface->h};
+		SetViewport(nullptr);
+		UpdateColor();
+	}
+
+	void SurfaceRasterizer::SetDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+		m_color[0] = r;
+		m_color[1] = g;
+		m_color[2] = b;
+		m_color[3] = a;
+		UpdateColor();
+	}
+
+	void SurfaceRasterizer::SetBlendMode(SDL_BlendMode blendMode){
+		if(!SupportsBlendMode(blendMode))
+			throw std::invalid_argument("SurfaceRasterizer: unsupported blend mode");
+		m_blendMode = blendMode;
+		UpdateColor();
+	}
+
+	void SurfaceRasterizer::SetViewport(const Rect* rect){
+		m_viewport = rect != nullptr ? *rect : Rect{0, 0, m_surface->w, m_surface->h};
+		UpdateClip();
+	}
+
+	void SurfaceRasterizer::SetClipRect(const Rect* rect){
+		m_clipEnabled = rect != nullptr;
+		if(m_clipEnabled)
+			m_clipRect = *rect;
+		UpdateClip();
+	}
+
+	void SurfaceRasterizer::SetBounds(const Rect* rect){
+		const Rect surfaceRect{0, 0, m_surface->w, m_surface->h};
+		if(rect == nullptr || !SDL_IntersectRect(&surfaceRect, rect, &m_bounds))
+			m_bounds = rect == nullptr ? surfaceRect : Rect{0, 0, 0, 0};
+		UpdateClip();
+	}
+
+	void SurfaceRasterizer::UpdateColor(){
+		const auto* format = m_surface->format;
+		unsigned r = m_color[0];
+		unsigned g = m_color[1];
+		unsigned b = m_color[2];
+		const unsigned a = m_color[3];
+		m_pixel = SDL_MapRGBA(format, r, g, b, a);
+
+		// SDL premultiplies the draw color for these two modes.
+		if(m_blendMode == SDL_BLENDMODE_BLEND || m_blendMode == SDL_BLENDMODE_ADD){
+			r = r * a / 255;
+			g = g * a / 255;
+			b = b * a / 255;
+		}
+
+		// Padding bytes of formats without alpha come out as zero.
+		m_op = BlendOp{};
+		const struct{
+			uint8_t shift;
+			unsigned value;
+		} channels[] = {{format->Rshift, r}, {format->Gshift, g}, {format->Bshift, b}};
+		for(const auto& channel : channels){
+			const auto byte = channel.shift / 8;
+			switch(m_blendMode){
+				case SDL_BLENDMODE_BLEND:
+					m_op.mul[byte] = static_cast<uint8_t>(255 - a);
+					m_op.add[byte] = static_cast<uint8_t>(channel.value);
+					break;
+				case SDL_BLENDMODE_ADD:
+					m_op.mul[byte] = 255;
+					m_op.add[byte] = static_cast<uint8_t>(channel.value);
+					break;
+				case SDL_BLENDMODE_MOD:
+					m_op.mul[byte] = static_cast<uint8_t>(channel.value);
+					break;
+				default:
+					break;
+			}
+		}
+		if(format->Amask != 0){
+			const auto byte = format->Ashift / 8;
+			m_op.mul[byte] = static_cast<uint8_t>(m_blendMode == SDL_BLENDMODE_BLEND ? 255 - a : 255);
+			m_op.add[byte] = static_cast<uint8_t>(m_blendMode == SDL_BLENDMODE_BLEND ? a : 0);
+		}
+	}
+
+	void SurfaceRasterizer::UpdateClip(){
+		// Same as SDL's software renderer: the clip rect is moved into the
+		// viewport and both are cut to the surface.
+		auto clip = m_viewport;
+		if(m_clipEnabled){
+			const Rect clipRect{m_clipRect.x + m_viewport.x, m_clipRect.y + m_viewport.y, m_clipRect.w, m_clipRect.h};
+			if(!SDL_IntersectRect(&m_viewport, &clipRect, &clip))
+				clip = Rect{0, 0, 0, 0};
+		}
+		if(!SDL_IntersectRect(&m_bounds, &clip, &m_clip))
+			m_clip = Rect{0, 0, 0, 0};
+	}
+
+	uint32_t* SurfaceRasterizer::Row(int y) const{
+		return reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(m_surface->pixels) + static_cast<std::ptrdiff_t>(y) * m_surface->pitch);
+	}
+
+	void SurfaceRasterizer::DrawPixel(int x, int y){
+		x += m_viewport.x;
+		y += m_viewport.y;
+		if(x < m_clip.x || y < m_clip.y || x >= m_clip.x + m_clip.w || y >= m_clip.y + m_clip.h)
+			return;
+		auto& pixel = Row(y)[x];
+		pixel = m_blendMode == SDL_BLENDMODE_NONE ? m_pixel : BlendPixel(pixel, m_op.mul, m_op.add);
+	}
+
+	void SurfaceRasterizer::DrawSpan(int x, int y, int length){
+		auto* pixels = Row(y) + x;
+		if(m_blendMode == SDL_BLENDMODE_NONE)
+			GetKernels().fill(pixels, length, m_pixel);
+		else
+			GetKernels().blend(pixels, length, m_op.mul, m_op.add);
+	}
+
+	void SurfaceRasterizer::DrawLine(int x1, int y1, int x2, int y2, bool drawLast){
+		// SDL cuts the line to the viewport size first, the remaining pixels
+		// are clipped one by one.
+		const Rect bounds{0, 0, m_viewport.w, m_viewport.h};
+		if(!SDL_IntersectRectAndLine(&bounds, &x1, &y1, &x2, &y2))
+			return;
+
+		const auto dx = std::abs(x2 - x1);
+		const auto dy = std::abs(y2 - y1);
+		const auto count = std::max(dx, dy) + (drawLast ? 1 : 0);
+		if(count <= 0)
+			return;
+
+		if(dy == 0){
+			// Pixels run from x1 towards x2, which may be left out.
+			const auto y = y1 + m_viewport.y;
+			if(y < m_clip.y || y >= m_clip.y + m_clip.h)
+				return;
+			const auto first = (x1 <= x2 ? x1 : x1 - count + 1) + m_viewport.x;
+			const auto begin = std::max(first, m_clip.x);
+			const auto end = std::min(first + count, m_clip.x + m_clip.w);
+			if(begin < end)
+				DrawSpan(begin, y, end - begin);
+			return;
+		}
+		if(dx == 0){
+			const auto x = x1 + m_viewport.x;
+			if(x < m_clip.x || x >= m_clip.x + m_clip.w)
+				return;
+			const auto first = (y1 <= y2 ? y1 : y1 - count + 1) + m_viewport.y;
+			const auto begin = std::max(first, m_clip.y);
+			const auto end = std::min(first + count, m_clip.y + m_clip.h);
+			if(m_blendMode == SDL_BLENDMODE_NONE){
+				for(auto y = begin; y < end; ++y)
+					Row(y)[x] = m_pixel;
+			}else{
+				for(auto y = begin; y < end; ++y)
+					Row(y)[x] = BlendPixel(Row(y)[x], m_op.mul, m_op.add);
+			}
+			return;
+		}
+
+		// SDL's BLINE steps.
+		int d, dinc1, dinc2, xinc1, xinc2, yinc1, yinc2;
+		if(dx >= dy){
+			d = 2 * dy - dx;
+			dinc1 = dy * 2;
+			dinc2 = (dy - dx) * 2;
+			xinc1 = 1;
+			xinc2 = 1;
+			yinc1 = 0;
+			yinc2 = 1;
+		}else{
+			d = 2 * dx - dy;
+			dinc1 = dx * 2;
+			dinc2 = (dx - dy) * 2;
+			xinc1 = 0;
+			xinc2 = 1;
+			yinc1 = 1;
+			yinc2 = 1;
+		}
+		if(x1 > x2){
+			xinc1 = -xinc1;
+			xinc2 = -xinc2;
+		}
+		if(y1 > y2){
+			yinc1 = -yinc1;
+			yinc2 = -yinc2;
+		}
+
+		// Only the steps inside the visible area along the major axis can
+		// draw, e.g. those crossing one tile of a long line.
+		const auto xMajor = dx >= dy;
+		const auto forward = xMajor ? x1 <= x2 : y1 <= y2;
+		const auto low = xMajor ? m_clip.x - m_viewport.x : m_clip.y - m_viewport.y;
+		const auto high = low + (xMajor ? m_clip.w : m_clip.h);
+		const auto start = xMajor ? x1 : y1;
+		const auto skip = forward ? low - start : start - (high - 1);
+		const auto limit = forward ? high : low - 1;
+		auto x = x1;
+		auto y = y1;
+		auto i = 0;
+		if(skip > 0){
+			if(skip >= count)
+				return;
+			// After k steps the minor axis has moved (2 * minor * k + major)
+			// / (2 * major) times; the error term follows from that.
+			const int64_t major = std::max(dx, dy);
+			const int64_t minor = std::min(dx, dy);
+			const auto minorSteps = (2 * minor * skip + major) / (2 * major);
+			d = static_cast<int>(2 * minor * (skip + 1) - major - 2 * major * minorSteps);
+			x += xMajor ? xinc1 * skip : xinc2 * static_cast<int>(minorSteps);
+			y += xMajor ? yinc2 * static_cast<int>(minorSteps) : yinc1 * skip;
+			i = skip;
+		}
+		for(; i < count; ++i){
+			const auto major = xMajor ? x : y;
+			if(forward ? major >= limit : major <= limit)
+				break;
+			DrawPixel(x, y);
+			if(d < 0){
+				d += dinc1;
+				x += xinc1;
+				y += yinc1;
+			}else{
+				d += dinc2;
+				x += xinc2;
+				y += yinc2;
+			}
+		}
+	}
+
+	void SurfaceRasterizer::DrawPolyline(const Point* points, std::size_t count, std::size_t firstSegment, std::size_t segmentCount){
+		if(count == 1){
+			if(firstSegment == 0 && segmentCount > 0)
+				DrawPixel(points[0].x, points[0].y);
+			return;
+		}
+		// Every segment leaves out its end point; the last one draws it
+		// unless the polyline is closed.
+		const auto closed = count > 1 && points[0].x == points[count - 1].x && points[0].y == points[count - 1].y;
+		const auto end = std::min(firstSegment + segmentCount, count - 1);
+		for(auto i = firstSegment; i < end; ++i)
+			DrawLine(points[i].x, points[i].y, points[i + 1].x, points[i + 1].y, i + 2 == count && !closed);
+	}
+
+	int SurfaceRasterizer::Clear(){
+		SurfaceLock lock(m_surface);
+		if(lock.GetResult() != 0)
+			return lock.GetResult();
+		for(auto y = m_bounds.y; y < m_bounds.y + m_bounds.h; ++y)
+			GetKernels().fill(Row(y) + m_bounds.x, m_bounds.w, m_pixel);
+		return 0;
+	}
+
+	int SurfaceRasterizer::DrawPoints(const Point* points, std::size_t count){
+		SurfaceLock lock(m_surface);
+		if(lock.GetResult() != 0)
+			return lock.GetResult();
+		for(std::size_t i = 0; i < count; ++i)
+			DrawPixel(points[i].x, points[i].y);
+		return 0;
+	}
+
+	int SurfaceRasterizer::DrawLines(const Point* points, std::size_t count){
+		SurfaceLock lock(m_surface);
+		if(lock.GetResult() != 0)
+			return lock.GetResult();
+		DrawPolyline(points, count, 0, count);
+		return 0;
+	}
+
+	int SurfaceRasterizer::DrawLines(const Point* points, std::size_t count, std::size_t firstSegment, std::size_t segmentCount){
+		SurfaceLock lock(m_surface);
+		if(lock.GetResult() != 0)
+			return lock.GetResult();
+		DrawPolyline(points, count, firstSegment, segmentCount);
+		return 0;
+	}
+
+	int SurfaceRasterizer::DrawRects(const Rect* rects, std::size_t count){
+		SurfaceLock lock(m_surface);
+		if(lock.GetResult() != 0)
+			return lock.GetResult();
+		for(std::size_t i = 0; i < count; ++i){
+			// The closed outline SDL_RenderDrawRect() draws.
+			const auto& rect = rects[i];
+			const Point outline[5] = {
+				{rect.x, rect.y},
+				{rect.x + rect.w - 1, rect.y},
+				{rect.x + rect.w - 1, rect.y + rect.h - 1},
+				{rect.x, rect.y + rect.h - 1},
+				{rect.x, rect.y}
+			};
+			DrawPolyline(outline, 5, 0, 4);
+		}
+		return 0;
+	}
+
+	int SurfaceRasterizer::FillRects(const Rect* rects, std::size_t count){
+		SurfaceLock lock(m_surface);
+		if(lock.GetResult() != 0)
+			return lock.GetResult();
+		for(std::size_t i = 0; i < count; ++i){
+			const Rect rect{rects[i].x + m_viewport.x, rects[i].y + m_viewport.y, rects[i].w, rects[i].h};
+			Rect clipped;
+			if(!SDL_IntersectRect(&rect, &m_clip, &clipped))
+				continue;
+			for(auto y = clipped.y; y < clipped.y + clipped.h; ++y)
+				DrawSpan(clipped.x, y, clipped.w);
+		}
+		return 0;
+	}
+
+}
@@ -0,0 +1,153 @@
+#include "readback.h"
+#include "error.h"
+#include "renderer.h"
+#include <SDL_pixels.h>
+#include <SDL_surface.h>
+#include <SDL_timer.h>
+#include <exception>
+#include <new>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		int Pitch(int width, uint32_t format){
+			if(SDL_ISPIXELFORMAT_FOURCC(format) || SDL_BYTESPERPIXEL(format) == 0)
+				throw std::invalid_argument("FrameReadback: packed pixel format required");
+			return (width * SDL_BYTESPERPIXEL(format) + 3) & ~3;
+		}
+
+	}
+
+	FrameReadback::FrameReadback(int width, int height, uint32_t readFormat, uint32_t outputFormat, std::size_t bufferCount, Consumer consumer):
+		m_width(width),
+		m_height(height),
+		m_readFormat(readFormat),
+		m_outputFormat(outputFormat),
+		m_readPitch(Pitch(width, readFormat)),
+		m_outputPitch(Pitch(width, outputFormat)),
+		m_consumer(std::move(consumer)),
+		m_buffers(bufferCount){
+		if(width <= 0 || height <= 0)
+			throw std::invalid_argument("FrameReadback: invalid size");
+		if(bufferCount == 0)
+			throw std::invalid_argument("FrameReadback: at least one buffer required");
+		if(!m_consumer)
+			throw std::invalid_argument("FrameReadback: no consumer");
+
+		for(auto& buffer : m_buffers)
+			buffer.pixels.resize(static_cast<std::size_t>(m_readPitch) * height);
+		if(m_outputFormat != m_readFormat)
+			m_converted.resize(static_cast<std::size_t>(m_outputPitch) * height);
+		m_worker = std::thread(&FrameReadback::Work, this);
+	}
+
+	FrameReadback::~FrameReadback(){
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_ready.notify_one();
+		m_worker.join();
+	}
+
+	bool FrameReadback::Capture(Renderer& renderer){
+		const Rect rect{0, 0, m_width, m_height};
+		return Capture(renderer, rect);
+	}
+
+	bool FrameReadback::Capture(Renderer& renderer, const Rect& rect){
+		if(rect.w != m_width || rect.h != m_height)
+			throw std::invalid_argument("FrameReadback: capture rect does not match the buffer size");
+
+		Buffer* buffer;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			const auto index = m_frames++;
+			if(m_written - m_consumed == m_buffers.size()){
+				++m_dropped;
+				return false;
+			}
+			// Only this thread advances m_written, so the slot stays ours
+			// after unlocking.
+			buffer = &m_buffers[m_written % m_buffers.size()];
+			buffer->index = index;
+		}
+		buffer->timestamp = SDL_GetTicks();
+		if(!renderer.RenderReadPixels(&rect, m_readFormat, buffer->pixels.data(), m_readPitch, std::nothrow)){
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_dropped;
+			return false;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			++m_written;
+		}
+		m_ready.notify_one();
+		return true;
+	}
+
+	void FrameReadback::Flush(){
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle.wait(lock, [this]{ return m_consumed == m_written; });
+		if(m_error){
+			auto error = m_error;
+			m_error = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+	uint64_t FrameReadback::GetCapturedCount() const{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_written;
+	}
+
+	uint64_t FrameReadback::GetDroppedCount() const{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_dropped;
+	}
+
+	void FrameReadback::Work(){
+		for(;;){
+			Buffer* buffer;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_ready.wait(lock, [this]{ return m_stop || m_consumed != m_written; });
+				if(m_consumed == m_written)
+					return;
+				buffer = &m_buffers[m_consumed % m_buffers.size()];
+			}
+
+			Frame frame{buffer->pixels.data(), m_width, m_height, m_readPitch, m_readFormat, buffer->index, buffer->timestamp};
+			std::exception_ptr error;
+			if(m_outputFormat != m_readFormat){
+				if(SDL_ConvertPixels(m_width, m_height, m_readFormat, buffer->pixels.data(), m_readPitch,
+				                     m_outputFormat, m_converted.data(), m_outputPitch) == 0){
+					frame.pixels = m_converted.data();
+					frame.pitch = m_outputPitch;
+					frame.format = m_outputFormat;
+				}else{
+					// The consumer only ever sees the output format.
+					error = std::make_exception_ptr(Error());
+				}
+			}
+			if(!error){
+				try{
+					m_consumer(frame);
+				}catch(...){
+					error = std::current_exception();
+				}
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				++m_consumed;
+				if(error && !m_error)
+					m_error = error;
+			}
+			m_idle.notify_all();
+		}
+	}
+
+}
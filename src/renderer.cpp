@@ -1,10 +1,25 @@
 #include "renderer.h"
+#include "commandbuffer.h"
 #include "error.h"
+#include "profiler.h"
+#include "rasterizer.h"
 #include "texture.h"
+#include "texturepool.h"
+#include "tiledrasterizer.h"
 #include <SDL.h>
+#include <cstddef>
 #include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 namespace SDL{
+	// The glm::ivec2 batch overloads hand their buffers to SDL as SDL_Point
+	// arrays without copying.
+	static_assert(std::is_standard_layout<glm::ivec2>::value, "glm::ivec2 must be standard layout");
+	static_assert(sizeof(glm::ivec2) == sizeof(SDL_Point), "glm::ivec2 and SDL_Point differ in size");
+	static_assert(offsetof(glm::ivec2, x) == offsetof(SDL_Point, x), "glm::ivec2::x and SDL_Point::x differ in offset");
+	static_assert(offsetof(glm::ivec2, y) == offsetof(SDL_Point, y), "glm::ivec2::y and SDL_Point::y differ in offset");
+
 	Renderer::Renderer(){
 		/*STUB*/
 	}
@@ -18,13 +33,47 @@ namespace SDL{
 	}
 
 
+	std::shared_ptr<Renderer> Renderer::CreateSoftwareRenderer(SDL_Surface* surface, SoftwareBackend backend){
+		auto* sdlRenderer = SDL_CreateSoftwareRenderer(surface);
+		if(sdlRenderer == nullptr)
+			throw Error();
+		auto renderer = std::make_shared<Renderer>(sdlRenderer);
+		if(backend == SoftwareBackend::Tiled && TiledRasterizer::Supports(surface)){
+			renderer->m_rasterizer = std::make_unique<SurfaceRasterizer>(surface);
+			renderer->m_tiled = std::make_unique<TiledRasterizer>(surface);
+			renderer->m_rasterizerLines = SurfaceRasterizer::SupportsLines();
+			renderer->SyncRasterizer();
+			renderer->EnableCommandBuffer(true);
+		}
+		return renderer;
+	}
+
+	SoftwareBackend Renderer::GetSoftwareBackend() const{
+		return m_tiled ? SoftwareBackend::Tiled : SoftwareBackend::SDL;
+	}
+
 	void Renderer::DestroyRenderer(){
+		// The target may hold the last reference to its texture, which has to
+		// go while the renderer still exists.
+		if(m_target){
+			SDL_SetRenderTarget(m_renderer, nullptr);
+			m_target.reset();
+		}
+		// SDL destroys the renderer's textures along with it.
+		// Pooled textures still held elsewhere must not come back or be
+		// destroyed again.
+		if(m_texturePool)
+			m_texturePool->MarkRendererDestroyed();
+		m_texturePool.reset();
+		m_tiled.reset();
+		m_rasterizer.reset();
+		m_rasterizerActive = false;
 		SDL_DestroyRenderer(m_renderer);
 		m_renderer = nullptr;
 	}
 
 
-	auto Renderer::GetNumRenderDrivers(){
+	int Renderer::GetNumRenderDrivers(){
 		auto numRenderDrivers = SDL_GetNumRenderDrivers();
 		if(numRenderDrivers >= 1)
 			return numRenderDrivers;
@@ -32,7 +81,7 @@ namespace SDL{
 			throw Error();
 	}
 
-	auto Renderer::GetRenderDriverInfo(int index){
+	SDL_RendererInfo Renderer::GetRenderDriverInfo(int index){
 		SDL_RendererInfo info;
 		if( SDL_GetRenderDriverInfo(index, &info) != 0)
 			throw Error();
@@ -40,7 +89,7 @@ namespace SDL{
 			return info;
 	}
 
-	auto Renderer::GetRendererInfo(){
+	SDL_RendererInfo Renderer::GetRendererInfo(){
 		SDL_RendererInfo info;
 		if(SDL_GetRendererInfo(m_renderer, &info) != 0)
 			throw Error();
@@ -48,7 +97,7 @@ namespace SDL{
 			return info;
 	}
 
-	auto Renderer::GetRendererOutputSize(){
+	glm::ivec2 Renderer::GetRendererOutputSize(){
 		glm::ivec2 wh;
 		if(SDL_GetRendererOutputSize(m_renderer, &(wh.x), &(wh.y)) != 0)
 			throw Error();
@@ -56,24 +105,53 @@ namespace SDL{
 			return wh;
 	}
 
-	auto Renderer::CreateTexture(uint32_t format, int access, int w, int h){
+	std::shared_ptr<Texture> Renderer::CreateTexture(uint32_t format, int access, int w, int h){
+		SDL2PP_PROFILE_ZONE(CreateTexture);
+		const TexturePool::Key key{format, access, w, h};
+		if(m_texturePool){
+			auto texture = m_texturePool->Acquire(key);
+			if(texture)
+				return texture;
+		}
+
 		auto* sdlTexture = SDL_CreateTexture(m_renderer, format, access, w, h);
 		if( sdlTexture == nullptr)
 			throw Error();
+		else if(m_texturePool)
+			return m_texturePool->Adopt(sdlTexture, key);
 		else
 			return std::make_shared<Texture>(sdlTexture);
 	}
 
-	auto Renderer::RenderTargetSupported(){
-		return SDL_RenderTargetSupported(m_renderer);
+	void Renderer::SetTexturePool(std::shared_ptr<TexturePool> pool){
+		m_texturePool = std::move(pool);
+	}
+
+	bool Renderer::RenderTargetSupported(){
+		return SDL_RenderTargetSupported(m_renderer) == SDL_TRUE;
 	}
 
 
+	Result Renderer::Check(int code){
+		if(code != 0)
+			m_frameErrors.Record(Result(code));
+		return Result(code);
+	}
+
 	void Renderer::RenderClear(){
-		if(SDL_RenderClear(m_renderer) != 0)
+		if(!RenderClear(std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderClear(const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderClear);
+		if(m_commandBuffer){
+			m_commandBuffer->Clear();
+			return Result();
+		}
+		return Check(DispatchClear());
+	}
+
 	void Renderer::RenderDrawPoint(glm::ivec2 p){
 		RenderDrawPoint(p.x, p.y);
 	}
@@ -92,15 +170,42 @@ namespace SDL{
 
 
 	void Renderer::RenderDrawPoint(int x, int y){
-		if(SDL_RenderDrawPoint(m_renderer, x, y) != 0)
+		if(!RenderDrawPoint(x, y, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderDrawPoint(int x, int y, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderDrawPoint);
+		if(m_commandBuffer){
+			m_commandBuffer->DrawPoint(x, y);
+			return Result();
+		}
+		const Point point{x, y};
+		return Check(DispatchPoints(&point, 1));
+	}
+
 	void Renderer::RenderDrawPoints(std::vector<Point>& points){
-		if(SDL_RenderDrawPoints(m_renderer, points.data(), points.size()) != 0)
+		RenderDrawPoints(Span<const Point>(points));
+	}
+
+	void Renderer::RenderDrawPoints(Span<const Point> points){
+		if(!RenderDrawPoints(points, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderDrawPoints(Span<const Point> points, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderDrawPoints);
+		if(m_commandBuffer){
+			m_commandBuffer->DrawPoints(points.data(), points.size());
+			return Result();
+		}
+		return Check(DispatchPoints(points.data(), points.size()));
+	}
+
+	void Renderer::RenderDrawPoints(Span<const glm::ivec2> points){
+		RenderDrawPoints(Span<const Point>(reinterpret_cast<const Point*>(points.data()), points.size()));
+	}
+
 	void Renderer::RenderDrawLine(glm::ivec2 p1, glm::ivec2 p2){
 		RenderDrawLine(p1.x, p1.y, p2.x, p2.y);
 	}
@@ -118,37 +223,205 @@ namespace SDL{
 	}
 
 	void Renderer::RenderDrawLine(int x1, int y1, int x2, int y2){
-		if(SDL_RenderDrawLine(m_renderer, x1, y1, x2, y2) != 0)
+		if(!RenderDrawLine(x1, y1, x2, y2, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderDrawLine(int x1, int y1, int x2, int y2, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderDrawLine);
+		if(m_commandBuffer){
+			m_commandBuffer->DrawLine(x1, y1, x2, y2);
+			return Result();
+		}
+		const Point points[] = {{x1, y1}, {x2, y2}};
+		return Check(DispatchLines(points, 2));
+	}
+
 	void Renderer::RenderDrawLines(std::vector<Point>& points){
-		if(SDL_RenderDrawLines(m_renderer, points.data(), points.size()) != 0)
+		RenderDrawLines(Span<const Point>(points));
+	}
+
+	void Renderer::RenderDrawLines(Span<const Point> points){
+		if(!RenderDrawLines(points, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderDrawLines(Span<const Point> points, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderDrawLines);
+		if(m_commandBuffer){
+			m_commandBuffer->DrawLines(points.data(), points.size());
+			return Result();
+		}
+		return Check(DispatchLines(points.data(), points.size()));
+	}
+
+	void Renderer::RenderDrawLines(Span<const glm::ivec2> points){
+		RenderDrawLines(Span<const Point>(reinterpret_cast<const Point*>(points.data()), points.size()));
+	}
+
 	void Renderer::RenderDrawRect(Rect& rect){
-		if(SDL_RenderDrawRect(m_renderer, &rect) != 0)
+		if(!RenderDrawRect(rect, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderDrawRect(const Rect& rect, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderDrawRect);
+		if(m_commandBuffer){
+			m_commandBuffer->DrawRect(rect);
+			return Result();
+		}
+		return Check(DispatchRects(&rect, 1));
+	}
+
 	void Renderer::RenderDrawRects(std::vector<Rect>& rects){
-		if(SDL_RenderDrawRects(m_renderer, rects.data(), rects.size()) != 0)
+		RenderDrawRects(Span<const Rect>(rects));
+	}
+
+	void Renderer::RenderDrawRects(Span<const Rect> rects){
+		if(!RenderDrawRects(rects, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderDrawRects(Span<const Rect> rects, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderDrawRects);
+		if(m_commandBuffer){
+			m_commandBuffer->DrawRects(rects.data(), rects.size());
+			return Result();
+		}
+		return Check(DispatchRects(rects.data(), rects.size()));
+	}
+
 	void Renderer::RenderFillRect(Rect& rect){
-		if(SDL_RenderFillRect(m_renderer, &rect) != 0)
+		if(!RenderFillRect(rect, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderFillRect(const Rect& rect, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderFillRect);
+		if(m_commandBuffer){
+			m_commandBuffer->FillRect(rect);
+			return Result();
+		}
+		return Check(DispatchFillRects(&rect, 1));
+	}
+
 	void Renderer::RenderFillRects(std::vector<Rect>& rects){
-		if(SDL_RenderFillRects(m_renderer, rects.data(), rects.size()) != 0)
+		RenderFillRects(Span<const Rect>(rects));
+	}
+
+	void Renderer::RenderFillRects(Span<const Rect> rects){
+		if(!RenderFillRects(rects, std::nothrow))
+			throw Error();
+	}
+
+	Result Renderer::RenderFillRects(Span<const Rect> rects, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderFillRects);
+		if(m_commandBuffer){
+			m_commandBuffer->FillRects(rects.data(), rects.size());
+			return Result();
+		}
+		return Check(DispatchFillRects(rects.data(), rects.size()));
+	}
+
+	void Renderer::RenderCopy(Texture& texture){
+		SDL2PP_PROFILE_ZONE(RenderCopy);
+		FlushCommandBuffer();
+		m_sdlPending = true;
+		if(SDL_RenderCopy(m_renderer, texture.Get(), nullptr, nullptr) != 0)
+			throw Error();
+	}
+
+	void Renderer::RenderCopy(Texture& texture, const Rect& srcRect, const Rect& dstRect){
+		if(!RenderCopy(texture, srcRect, dstRect, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::RenderCopy(Texture& texture, const Rect& srcRect, const Rect& dstRect, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(RenderCopy);
+		if(m_commandBuffer){
+			m_commandBuffer->Copy(texture.Get(), srcRect, dstRect);
+			return Result();
+		}
+		m_sdlPending = true;
+		return Check(SDL_RenderCopy(m_renderer, texture.Get(), &srcRect, &dstRect));
+	}
+
+	void Renderer::RenderCopies(Texture& texture, Span<const Rect> srcRects, Span<const Rect> dstRects){
+		SDL2PP_PROFILE_ZONE(RenderCopy);
+		if(srcRects.size() != dstRects.size())
+			throw std::invalid_argument("RenderCopies: source and destination counts differ");
+		if(m_commandBuffer){
+			m_commandBuffer->Copy(texture.Get(), srcRects.data(), dstRects.data(), srcRects.size());
+			return;
+		}
+		m_sdlPending = true;
+		for(std::size_t i = 0; i < srcRects.size(); ++i){
+			if(SDL_RenderCopy(m_renderer, texture.Get(), &srcRects[i], &dstRects[i]) != 0)
+				throw Error();
+		}
+	}
+
+	void Renderer::RenderCopyEx(Texture& texture, const Rect& srcRect, const Rect& dstRect, double angle, const Point* center, SDL_RendererFlip flip){
+		if(!RenderCopyEx(texture, srcRect, dstRect, angle, center, flip, std::nothrow))
+			throw Error();
+	}
+
+	Result Renderer::RenderCopyEx(Texture& texture, const Rect& srcRect, const Rect& dstRect, double angle, const Point* center, SDL_RendererFlip flip, const std::nothrow_t&){
+		const auto result = FlushCommandBuffer(std::nothrow);
+		if(!result)
+			return result;
+		SDL2PP_PROFILE_ZONE(RenderCopy);
+		m_sdlPending = true;
+		return Check(SDL_RenderCopyEx(m_renderer, texture.Get(), &srcRect, &dstRect, angle, center, flip));
+	}
+
 	void Renderer::RenderPresent(){
-		SDL_RenderPresent(m_renderer);
+		if(m_commandBuffer)
+			FlushCommandBuffer();
+		SubmitCommandLists();
+		{
+			SDL2PP_PROFILE_ZONE(RenderPresent);
+			SDL_RenderPresent(m_renderer);
+		}
+		EndFrame();
+	}
+
+	Result Renderer::RenderPresent(const std::nothrow_t&){
+		// Present whatever could be drawn, report the first failure.
+		auto result = FlushCommandBuffer(std::nothrow);
+		const auto lists = SubmitCommandLists(std::nothrow);
+		if(result)
+			result = lists;
+		{
+			SDL2PP_PROFILE_ZONE(RenderPresent);
+			SDL_RenderPresent(m_renderer);
+		}
+		EndFrame();
+		return result;
+	}
+
+	void Renderer::RenderReadPixels(const Rect* rect, uint32_t format, void* pixels, int pitch){
+		if(!RenderReadPixels(rect, format, pixels, pitch, std::nothrow))
+			throw Error();
+	}
+
+	Result Renderer::RenderReadPixels(const Rect* rect, uint32_t format, void* pixels, int pitch, const std::nothrow_t&){
+		const auto result = FlushCommandBuffer(std::nothrow);
+		if(!result)
+			return result;
+		SDL2PP_PROFILE_ZONE(RenderReadPixels);
+		return Check(SDL_RenderReadPixels(m_renderer, rect, format, pixels, pitch));
+	}
+
+	void Renderer::EndFrame(){
+		SDL2PP_PROFILE_END_FRAME();
+		m_lastStateStats = m_stateStats;
+		m_stateStats = RenderStateStats();
+		m_lastFrameErrors = m_frameErrors;
+		m_frameErrors.Reset();
+		// Textures released on other threads are reset here.
+		if(m_texturePool)
+			m_texturePool->Collect();
 	}
 	
 	void Renderer::SetRenderDrawColor(glm::i8vec4 color){
@@ -160,73 +433,503 @@ namespace SDL{
 	}
 	
 	void Renderer::SetRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
-		if(SDL_SetRenderDrawColor(m_renderer, r, g, b, a) != 0)
+		if(!SetRenderDrawColor(r, g, b, a, std::nothrow))
 			throw Error();
 	}
 
+	Result Renderer::SetRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a, const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(SetRenderDrawColor);
+		if(m_commandBuffer){
+			m_commandBuffer->SetDrawColor(r, g, b, a);
+			return Result();
+		}
+		return Check(ApplyRenderDrawColor(r, g, b, a));
+	}
+
+	int Renderer::ApplyRenderDrawColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+		auto* color = m_state.drawColor;
+		if(m_state.drawColorKnown && color[0] == r && color[1] == g && color[2] == b && color[3] == a){
+			++m_stateStats.drawColor.elided;
+			return 0;
+		}
+		++m_stateStats.drawColor.issued;
+		auto result = SDL_SetRenderDrawColor(m_renderer, r, g, b, a);
+		m_state.drawColorKnown = result == 0;
+		if(m_rasterizer && result == 0)
+			m_rasterizer->SetDrawColor(r, g, b, a);
+		color[0] = r;
+		color[1] = g;
+		color[2] = b;
+		color[3] = a;
+		return result;
+	}
+
+	glm::i8vec4 Renderer::GetRenderDrawColor(){
+		glm::i8vec4 color;
+		if(!GetRenderDrawColor(color, std::nothrow))
+			throw Error();
+		return color;
+	}
+
+	Result Renderer::GetRenderDrawColor(glm::i8vec4& color, const std::nothrow_t&){
+		if(m_commandBuffer){
+			auto bufferColor = m_commandBuffer->GetDrawColor();
+			color = glm::i8vec4(bufferColor.r, bufferColor.g, bufferColor.b, bufferColor.a);
+			return Result();
+		}
+		auto* cached = m_state.drawColor;
+		if(!m_state.drawColorKnown){
+			const auto result = Check(SDL_GetRenderDrawColor(m_renderer, &cached[0], &cached[1], &cached[2], &cached[3]));
+			if(!result)
+				return result;
+			m_state.drawColorKnown = true;
+		}
+		color = glm::i8vec4(cached[0], cached[1], cached[2], cached[3]);
+		return Result();
+	}
+
+	void Renderer::SetRenderDrawBlendMode(SDL_BlendMode blendMode){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		if(m_state.blendModeKnown && m_state.blendMode == blendMode){
+			++m_stateStats.blendMode.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.blendMode.issued;
+		m_state.blendModeKnown = false;
+		if(SDL_SetRenderDrawBlendMode(m_renderer, blendMode) != 0)
+			throw Error();
+		m_state.blendMode = blendMode;
+		m_state.blendModeKnown = true;
+		SyncRasterizer();
+	}
+
+	SDL_BlendMode Renderer::GetRenderDrawBlendMode(){
+		if(!m_state.blendModeKnown){
+			if(SDL_GetRenderDrawBlendMode(m_renderer, &m_state.blendMode) != 0)
+				throw Error();
+			m_state.blendModeKnown = true;
+		}
+		return m_state.blendMode;
+	}
+
+	void Renderer::RenderSetViewport(const Rect& rect){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		if(m_state.viewportKnown && m_state.viewportSet && SDL_RectEquals(&m_state.viewport, &rect)){
+			++m_stateStats.viewport.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.viewport.issued;
+		m_state.viewportKnown = false;
+		if(SDL_RenderSetViewport(m_renderer, &rect) != 0)
+			throw Error();
+		m_state.viewport = rect;
+		m_state.viewportSet = true;
+		m_state.viewportKnown = true;
+		SyncRasterizer();
+	}
+
+	void Renderer::RenderSetViewport(){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		if(m_state.viewportKnown && !m_state.viewportSet){
+			++m_stateStats.viewport.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.viewport.issued;
+		m_state.viewportKnown = false;
+		if(SDL_RenderSetViewport(m_renderer, nullptr) != 0)
+			throw Error();
+		m_state.viewportSet = false;
+		m_state.viewportKnown = true;
+		SyncRasterizer();
+	}
+
+	Rect Renderer::RenderGetViewport(){
+		Rect rect;
+		SDL_RenderGetViewport(m_renderer, &rect);
+		return rect;
+	}
+
+	void Renderer::RenderSetClipRect(const Rect& rect){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		if(m_state.clipRectKnown && m_state.clipEnabled && SDL_RectEquals(&m_state.clipRect, &rect)){
+			++m_stateStats.clipRect.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.clipRect.issued;
+		m_state.clipRectKnown = false;
+		if(SDL_RenderSetClipRect(m_renderer, &rect) != 0)
+			throw Error();
+		m_state.clipRect = rect;
+		m_state.clipEnabled = true;
+		m_state.clipRectKnown = true;
+		SyncRasterizer();
+	}
+
+	void Renderer::RenderSetClipRect(){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		if(m_state.clipRectKnown && !m_state.clipEnabled){
+			++m_stateStats.clipRect.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.clipRect.issued;
+		m_state.clipRectKnown = false;
+		if(SDL_RenderSetClipRect(m_renderer, nullptr) != 0)
+			throw Error();
+		m_state.clipEnabled = false;
+		m_state.clipRectKnown = true;
+		SyncRasterizer();
+	}
+
+	Rect Renderer::RenderGetClipRect(){
+		if(m_state.clipRectKnown)
+			return m_state.clipEnabled ? m_state.clipRect : Rect{0, 0, 0, 0};
+		Rect rect;
+		SDL_RenderGetClipRect(m_renderer, &rect);
+		return rect;
+	}
+
+	bool Renderer::RenderIsClipEnabled(){
+		if(m_state.clipRectKnown)
+			return m_state.clipEnabled;
+		return SDL_RenderIsClipEnabled(m_renderer) == SDL_TRUE;
+	}
+
+	Rect Renderer::RenderGetVisibleRect(){
+		const auto viewport = RenderGetViewport();
+		Rect visible{0, 0, viewport.w, viewport.h};
+		if(RenderIsClipEnabled()){
+			// The clip rect is relative to the viewport as well.
+			const auto clip = RenderGetClipRect();
+			if(!SDL_IntersectRect(&visible, &clip, &visible))
+				return Rect{0, 0, 0, 0};
+		}
+		return visible;
+	}
+
+	void Renderer::RenderSetScale(float scaleX, float scaleY){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		if(m_state.scaleKnown && m_state.scale.x == scaleX && m_state.scale.y == scaleY){
+			++m_stateStats.scale.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.scale.issued;
+		m_state.scaleKnown = false;
+		if(SDL_RenderSetScale(m_renderer, scaleX, scaleY) != 0)
+			throw Error();
+		m_state.scale = glm::vec2(scaleX, scaleY);
+		m_state.scaleKnown = true;
+		SyncRasterizer();
+	}
+
+	glm::vec2 Renderer::RenderGetScale(){
+		if(!m_state.scaleKnown){
+			SDL_RenderGetScale(m_renderer, &m_state.scale.x, &m_state.scale.y);
+			m_state.scaleKnown = true;
+		}
+		return m_state.scale;
+	}
+
+	void Renderer::SetRenderTarget(std::shared_ptr<Texture> texture){
+		SDL2PP_PROFILE_ZONE(SetRenderState);
+		auto* sdlTexture = texture ? texture->Get() : nullptr;
+		auto* current = m_target ? m_target->Get() : nullptr;
+		if(m_state.targetKnown && sdlTexture == current){
+			++m_stateStats.target.elided;
+			return;
+		}
+		FlushCommandBuffer();
+		++m_stateStats.target.issued;
+		m_state.targetKnown = false;
+		if(SDL_SetRenderTarget(m_renderer, sdlTexture) != 0)
+			throw Error();
+		m_target = std::move(texture);
+		m_state.targetKnown = true;
+
+		// SDL keeps viewport, clip rect and scale per target.
+		m_state.viewportKnown = false;
+		m_state.clipRectKnown = false;
+		m_state.scaleKnown = false;
+		SyncRasterizer();
+	}
+
+	void Renderer::InvalidateRenderState(){
+		m_state = RenderState();
+		SyncRasterizer();
+	}
+
+	void Renderer::EnableCommandBuffer(bool enable){
+		if(enable == IsCommandBufferEnabled())
+			return;
+		if(enable){
+			auto color = GetRenderDrawColor();
+			m_commandBuffer = std::make_unique<RenderCommandBuffer>(color.r, color.g, color.b, color.a);
+		}else{
+			FlushCommandBuffer();
+			m_commandBuffer.reset();
+		}
+	}
+
+	void Renderer::FlushCommandBuffer(){
+		if(!FlushCommandBuffer(std::nothrow))
+			throw Error();
+	}
+
+	Result Renderer::FlushCommandBuffer(const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(FlushCommandBuffer);
+		if(!m_commandBuffer || m_commandBuffer->Empty())
+			return Result();
+
+		auto& buffer = *m_commandBuffer;
+		auto result = SubmitCommandBuffer(buffer);
+
+		// The recorded color is the one callers expect to be active afterwards.
+		if(result == 0){
+			const auto color = buffer.GetDrawColor();
+			result = ApplyRenderDrawColor(color.r, color.g, color.b, color.a);
+		}
+		return Check(result);
+	}
+
+	void Renderer::SetCommandListCount(std::size_t count){
+		m_commandLists.resize(count);
+		for(auto& list : m_commandLists){
+			if(!list)
+				list = std::make_unique<RenderCommandBuffer>();
+		}
+	}
+
+	RenderCommandBuffer& Renderer::GetCommandList(std::size_t slot){
+		return *m_commandLists.at(slot);
+	}
+
+	void Renderer::SubmitCommandLists(){
+		if(!SubmitCommandLists(std::nothrow))
+			throw Error();
+	}
+
+	Result Renderer::SubmitCommandLists(const std::nothrow_t&){
+		SDL2PP_PROFILE_ZONE(SubmitCommandLists);
+		// The renderer's own commands were recorded first.
+		const auto flushResult = FlushCommandBuffer(std::nothrow);
+		auto pending = false;
+		for(const auto& list : m_commandLists){
+			pending = pending || !list->Empty();
+			if(list->Empty())
+				list->SetDrawColor(0, 0, 0, 255);
+		}
+		if(!pending)
+			return flushResult;
+
+		// Without the current color the lists are still drawn, it just
+		// cannot be restored afterwards.
+		glm::i8vec4 color;
+		const auto colorResult = GetRenderDrawColor(color, std::nothrow);
+		auto result = 0;
+		for(auto& list : m_commandLists){
+			if(result == 0)
+				result = SubmitCommandBuffer(*list);
+			else
+				list->Reset();
+			list->SetDrawColor(0, 0, 0, 255);
+		}
+		if(colorResult && result == 0)
+			result = ApplyRenderDrawColor(color.r, color.g, color.b, color.a);
+		if(!flushResult)
+			return flushResult;
+		return result == 0 ? colorResult : Check(result);
+	}
+
+	int Renderer::SubmitCopy(const RenderCommandBuffer& buffer, std::size_t index){
+		const auto& command = buffer.GetCommands()[index];
+		const auto* rects = buffer.GetRects(command);
+		m_sdlPending = true;
+		auto result = 0;
+		for(uint32_t i = 0; i < command.count && result == 0; ++i)
+			result = SDL_RenderCopy(m_renderer, command.texture, &rects[2 * i], &rects[2 * i + 1]);
+		return result;
+	}
+
+	int Renderer::SubmitTiled(RenderCommandBuffer& buffer){
+		// Primitives between copies go to the tiles in one parallel pass,
+		// the copies themselves to SDL, and so do lines the rasterizer can't
+		// match.
+		const auto& commands = buffer.GetCommands();
+		auto toSDL = [&](const RenderCommandBuffer::Command& command){
+			return command.type == RenderCommandBuffer::Type::Copy
+				|| (command.type == RenderCommandBuffer::Type::Lines && !m_rasterizerLines);
+		};
+		auto result = 0;
+		std::size_t first = 0;
+		while(first < commands.size() && result == 0){
+			auto last = first;
+			while(last < commands.size() && !toSDL(commands[last]))
+				++last;
+			if(last > first){
+				result = FlushSDL();
+				if(result == 0)
+					result = m_tiled->Draw(buffer, first, last);
+			}
+			if(last < commands.size() && result == 0){
+				const auto& command = commands[last];
+				if(command.type == RenderCommandBuffer::Type::Copy){
+					result = SubmitCopy(buffer, last);
+				}else{
+					result = ApplyRenderDrawColor(command.color.r, command.color.g, command.color.b, command.color.a);
+					if(result == 0)
+						result = DispatchLines(buffer.GetPoints(command), command.count);
+				}
+				++last;
+			}
+			first = last;
+		}
+		buffer.Reset();
+		return result;
+	}
+
+	int Renderer::FlushSDL(){
+		if(!m_sdlPending)
+			return 0;
+		m_sdlPending = false;
+		return SDL_RenderFlush(m_renderer);
+	}
+
+	void Renderer::SyncRasterizer(){
+		if(!m_rasterizer)
+			return;
+		// Read back from SDL, so state set through the C API is picked up by
+		// InvalidateRenderState() as well.
+		uint8_t r = 0, g = 0, b = 0, a = 0;
+		SDL_GetRenderDrawColor(m_renderer, &r, &g, &b, &a);
+		m_rasterizer->SetDrawColor(r, g, b, a);
+
+		Rect viewport;
+		SDL_RenderGetViewport(m_renderer, &viewport);
+		Rect clipRect;
+		const auto clipEnabled = SDL_RenderIsClipEnabled(m_renderer) == SDL_TRUE;
+		if(clipEnabled)
+			SDL_RenderGetClipRect(m_renderer, &clipRect);
+		m_rasterizer->SetViewport(&viewport);
+		m_rasterizer->SetClipRect(clipEnabled ? &clipRect : nullptr);
+
+		// Scaled drawing, render targets and blend modes without a kernel
+		// stay with SDL.
+		auto blendMode = SDL_BLENDMODE_NONE;
+		SDL_GetRenderDrawBlendMode(m_renderer, &blendMode);
+		auto scaleX = 1.0f, scaleY = 1.0f;
+		SDL_RenderGetScale(m_renderer, &scaleX, &scaleY);
+		m_rasterizerActive = SurfaceRasterizer::SupportsBlendMode(blendMode) && scaleX == 1.0f && scaleY == 1.0f
+			&& SDL_GetRenderTarget(m_renderer) == nullptr;
+		if(!SurfaceRasterizer::SupportsBlendMode(blendMode))
+			return;
+		m_rasterizer->SetBlendMode(blendMode);
+
+		if(m_tiled){
+			m_tiled->SetViewport(&viewport);
+			m_tiled->SetClipRect(clipEnabled ? &clipRect : nullptr);
+			m_tiled->SetBlendMode(blendMode);
+		}
+	}
+
+	int Renderer::DispatchClear(){
+		if(!m_rasterizerActive){
+			m_sdlPending = true;
+			return SDL_RenderClear(m_renderer);
+		}
+		const auto result = FlushSDL();
+		return result != 0 ? result : m_rasterizer->Clear();
+	}
+
+	int Renderer::DispatchPoints(const Point* points, std::size_t count){
+		if(!m_rasterizerActive){
+			m_sdlPending = true;
+			return SDL_RenderDrawPoints(m_renderer, points, count);
+		}
+		const auto result = FlushSDL();
+		return result != 0 ? result : m_rasterizer->DrawPoints(points, count);
+	}
+
+	int Renderer::DispatchLines(const Point* points, std::size_t count){
+		if(!m_rasterizerActive || !m_rasterizerLines){
+			m_sdlPending = true;
+			return SDL_RenderDrawLines(m_renderer, points, count);
+		}
+		const auto result = FlushSDL();
+		return result != 0 ? result : m_rasterizer->DrawLines(points, count);
+	}
+
+	int Renderer::DispatchRects(const Rect* rects, std::size_t count){
+		if(!m_rasterizerActive){
+			m_sdlPending = true;
+			return SDL_RenderDrawRects(m_renderer, rects, count);
+		}
+		const auto result = FlushSDL();
+		return result != 0 ? result : m_rasterizer->DrawRects(rects, count);
+	}
+
+	int Renderer::DispatchFillRects(const Rect* rects, std::size_t count){
+		if(!m_rasterizerActive){
+			m_sdlPending = true;
+			return SDL_RenderFillRects(m_renderer, rects, count);
+		}
+		const auto result = FlushSDL();
+		return result != 0 ? result : m_rasterizer->FillRects(rects, count);
+	}
+
+	int Renderer::SubmitCommandBuffer(RenderCommandBuffer& buffer){
+		if(m_tiled && m_rasterizerActive)
+			return SubmitTiled(buffer);
+
+		auto result = 0;
+		const auto& commands = buffer.GetCommands();
+		for(std::size_t index = 0; index < commands.size(); ++index){
+			const auto& command = commands[index];
+			const auto& color = command.color;
+			if(command.type != RenderCommandBuffer::Type::Copy)
+				result = ApplyRenderDrawColor(color.r, color.g, color.b, color.a);
+			if(result != 0)
+				break;
+
+			switch(command.type){
+				case RenderCommandBuffer::Type::Clear:
+					result = DispatchClear();
+					break;
+				case RenderCommandBuffer::Type::Points:
+					result = DispatchPoints(buffer.GetPoints(command), command.count);
+					break;
+				case RenderCommandBuffer::Type::Lines:
+					result = DispatchLines(buffer.GetPoints(command), command.count);
+					break;
+				case RenderCommandBuffer::Type::Rects:
+					result = DispatchRects(buffer.GetRects(command), command.count);
+					break;
+				case RenderCommandBuffer::Type::FillRects:
+					result = DispatchFillRects(buffer.GetRects(command), command.count);
+					break;
+				case RenderCommandBuffer::Type::Copy:
+					result = SubmitCopy(buffer, index);
+					break;
+			}
+			if(result != 0)
+				break;
+		}
+		buffer.Reset();
+		return result;
+	}
+
 
 
-	// static SDL_Renderer * SDL_CreateSoftwareRenderer(SDL_Surface * surface);
-	// 
-	// 
 	// extern DECLSPEC SDL_Texture * SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface);
 	// 
-	// extern DECLSPEC int SDL_SetRenderTarget(SDL_Renderer *renderer,
-	//                                                 SDL_Texture *texture);
-	// 
-	// extern DECLSPEC SDL_Texture * SDL_GetRenderTarget(SDL_Renderer *renderer);
-	// 
 	// extern DECLSPEC int SDL_RenderSetLogicalSize(SDL_Renderer * renderer, int w, int h);
 	// 
 	// extern DECLSPEC void SDL_RenderGetLogicalSize(SDL_Renderer * renderer, int *w, int *h);
 	// 
-	// extern DECLSPEC int SDL_RenderSetViewport(SDL_Renderer * renderer,
-	//                                                   const SDL_Rect * rect);
-	// 
-	// extern DECLSPEC void SDL_RenderGetViewport(SDL_Renderer * renderer,
-	//                                                    SDL_Rect * rect);
-	// 
-	// extern DECLSPEC int SDL_RenderSetClipRect(SDL_Renderer * renderer,
-	//                                                   const SDL_Rect * rect);
-	// 
-	// extern DECLSPEC void SDL_RenderGetClipRect(SDL_Renderer * renderer,
-	//                                                    SDL_Rect * rect);
-	// 
-	// extern DECLSPEC int SDL_RenderSetScale(SDL_Renderer * renderer,
-	//                                                float scaleX, float scaleY);
-	// 
-	// extern DECLSPEC void SDL_RenderGetScale(SDL_Renderer * renderer,
-	//                                                float *scaleX, float *scaleY);
-	// 
-	// extern DECLSPEC int SDL_GetRenderDrawColor(SDL_Renderer * renderer,
-	//                                            uint8_t * r, uint8_t * g, uint8_t * b,
-	//                                            uint8_t * a);
-	// 
-	// extern DECLSPEC int SDL_SetRenderDrawBlendMode(SDL_Renderer * renderer,
-	//                                                        SDL_BlendMode blendMode);
-	// 
-	// extern DECLSPEC int SDL_GetRenderDrawBlendMode(SDL_Renderer * renderer,
-	//                                                        SDL_BlendMode *blendMode);
-	// 
-
-	// extern DECLSPEC int SDL_RenderCopy(SDL_Renderer * renderer,
-	//                                            SDL_Texture * texture,
-	//                                            const SDL_Rect * srcrect,
-	//                                            const SDL_Rect * dstrect);
-	// 
-	// extern DECLSPEC int SDL_RenderCopyEx(SDL_Renderer * renderer,
-	//                                            SDL_Texture * texture,
-	//                                            const SDL_Rect * srcrect,
-	//                                            const SDL_Rect * dstrect,
-	//                                            const double angle,
-	//                                            const SDL_Point *center,
-	//                                            const SDL_RendererFlip flip);
-	// 
-	// extern DECLSPEC int SDL_RenderReadPixels(SDL_Renderer * renderer,
-	//                                                  const SDL_Rect * rect,
-	//                                                  uint32_t format,
-	//                                                  void *pixels, int pitch);
-	// 
 
 
 }
@@ -0,0 +1,38 @@
+#include "result.h"
+#include "error.h"
+#include <SDL_error.h>
+#include <cstring>
+
+namespace SDL{
+
+	std::string Result::GetMessage() const{
+		if(Ok())
+			return std::string();
+		return Error::Get();
+	}
+
+	void Result::ThrowIfFailed() const{
+		if(!Ok())
+			throw Error();
+	}
+
+	void ErrorAccumulator::RecordFailure(int code){
+		if(m_failures++ != 0)
+			return;
+		m_firstCode = code;
+		std::strncpy(m_firstMessage.data(), SDL_GetError(), m_firstMessage.size() - 1);
+		m_firstMessage.back() = '\0';
+	}
+
+	void ErrorAccumulator::Reset(){
+		m_failures = 0;
+		m_firstCode = 0;
+		m_firstMessage.front() = '\0';
+	}
+
+	void ErrorAccumulator::ThrowIfFailed() const{
+		if(!Ok())
+			throw Error(GetFirstMessage());
+	}
+
+}
@@ -0,0 +1,65 @@
+#include "scene.h"
+#include "renderer.h"
+#include "spritebatch.h"
+
+namespace SDL{
+
+	Scene::Scene(const Rect& world, int cellSize):m_grid(world, cellSize){
+
+	}
+
+	Scene::Handle Scene::AddSprite(Texture& texture, const Rect& srcRect, const Rect& bounds, int layer, SDL_BlendMode blendMode){
+		const auto handle = m_grid.Insert(bounds);
+		if(handle >= m_sprites.size())
+			m_sprites.resize(handle + 1);
+		m_sprites[handle] = Sprite{&texture, srcRect, bounds, layer, blendMode};
+		return handle;
+	}
+
+	void Scene::MoveSprite(Handle handle, const Rect& bounds){
+		m_grid.Move(handle, bounds);
+		m_sprites[handle].bounds = bounds;
+	}
+
+	void Scene::RemoveSprite(Handle handle){
+		m_grid.Remove(handle);
+		m_sprites[handle].texture = nullptr;
+	}
+
+	void Scene::Clear(){
+		m_grid.Clear();
+		m_sprites.clear();
+	}
+
+	const Scene::Sprite& Scene::GetSprite(Handle handle) const{
+		// Validates the handle.
+		m_grid.GetBounds(handle);
+		return m_sprites[handle];
+	}
+
+	std::size_t Scene::Queue(SpriteBatch& batch, const Rect& view, Point origin){
+		m_visible.clear();
+		m_grid.Query(view, m_visible);
+		for(auto handle : m_visible){
+			const auto& sprite = m_sprites[handle];
+			const Rect dstRect{sprite.bounds.x - origin.x, sprite.bounds.y - origin.y, sprite.bounds.w, sprite.bounds.h};
+			batch.Draw(*sprite.texture, sprite.srcRect, dstRect, sprite.layer, sprite.blendMode);
+		}
+		return m_visible.size();
+	}
+
+	std::size_t Scene::Draw(SpriteBatch& batch, const Rect& view){
+		return Queue(batch, view, Point{view.x, view.y});
+	}
+
+	std::size_t Scene::Draw(Renderer& renderer, SpriteBatch& batch, Point camera){
+		// The visible rect need not start at the origin when clipping.
+		auto view = renderer.RenderGetVisibleRect();
+		view.x += camera.x;
+		view.y += camera.y;
+		const auto count = Queue(batch, view, camera);
+		batch.Flush();
+		return count;
+	}
+
+}
@@ -0,0 +1,143 @@
+#include "spatialgrid.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		bool Intersects(const Rect& a, const Rect& b){
+			return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+		}
+
+		// Floor division, also for coordinates left of or above the world.
+		int CellOf(int coordinate, int origin, int cellSize){
+			const auto offset = coordinate - origin;
+			return offset >= 0 ? offset / cellSize : -((-offset + cellSize - 1) / cellSize);
+		}
+
+	}
+
+	SpatialGrid::SpatialGrid(const Rect& world, int cellSize):m_world(world), m_cellSize(cellSize){
+		if(cellSize <= 0 || world.w <= 0 || world.h <= 0)
+			throw std::invalid_argument("SpatialGrid: world and cell size must not be empty");
+		m_cellsX = (world.w + cellSize - 1) / cellSize;
+		m_cellsY = (world.h + cellSize - 1) / cellSize;
+		m_cells.resize(static_cast<std::size_t>(m_cellsX) * m_cellsY);
+	}
+
+	SpatialGrid::CellRange SpatialGrid::GetCells(const Rect& bounds) const{
+		auto clampX = [this](int cell){ return std::min(std::max(cell, 0), m_cellsX - 1); };
+		auto clampY = [this](int cell){ return std::min(std::max(cell, 0), m_cellsY - 1); };
+		return CellRange{
+			clampX(CellOf(bounds.x, m_world.x, m_cellSize)),
+			clampY(CellOf(bounds.y, m_world.y, m_cellSize)),
+			clampX(CellOf(bounds.x + std::max(bounds.w, 1) - 1, m_world.x, m_cellSize)),
+			clampY(CellOf(bounds.y + std::max(bounds.h, 1) - 1, m_world.y, m_cellSize))
+		};
+	}
+
+	void SpatialGrid::AddToCells(Handle handle, const CellRange& cells){
+		for(auto y = cells.y0; y <= cells.y1; ++y){
+			for(auto x = cells.x0; x <= cells.x1; ++x)
+				m_cells[static_cast<std::size_t>(y) * m_cellsX + x].push_back(handle);
+		}
+	}
+
+	void SpatialGrid::RemoveFromCells(Handle handle, const CellRange& cells){
+		for(auto y = cells.y0; y <= cells.y1; ++y){
+			for(auto x = cells.x0; x <= cells.x1; ++x){
+				auto& cell = m_cells[static_cast<std::size_t>(y) * m_cellsX + x];
+				const auto it = std::find(cell.begin(), cell.end(), handle);
+				*it = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+
+	const SpatialGrid::Entry& SpatialGrid::GetEntry(Handle handle) const{
+		if(handle >= m_entries.size() || !m_entries[handle].live)
+			throw std::out_of_range("SpatialGrid: invalid handle");
+		return m_entries[handle];
+	}
+
+	SpatialGrid::Handle SpatialGrid::Insert(const Rect& bounds){
+		Handle handle;
+		if(!m_freeHandles.empty()){
+			handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+		}else{
+			handle = static_cast<Handle>(m_entries.size());
+			m_entries.emplace_back();
+			m_queryMarks.push_back(0);
+		}
+		auto& entry = m_entries[handle];
+		entry.bounds = bounds;
+		entry.cells = GetCells(bounds);
+		entry.live = true;
+		AddToCells(handle, entry.cells);
+		++m_size;
+		return handle;
+	}
+
+	void SpatialGrid::Move(Handle handle, const Rect& bounds){
+		GetEntry(handle);
+		auto& entry = m_entries[handle];
+		entry.bounds = bounds;
+		const auto cells = GetCells(bounds);
+		if(cells == entry.cells)
+			return;
+		RemoveFromCells(handle, entry.cells);
+		AddToCells(handle, cells);
+		entry.cells = cells;
+	}
+
+	void SpatialGrid::Remove(Handle handle){
+		GetEntry(handle);
+		auto& entry = m_entries[handle];
+		RemoveFromCells(handle, entry.cells);
+		entry.live = false;
+		m_freeHandles.push_back(handle);
+		--m_size;
+	}
+
+	void SpatialGrid::Clear(){
+		for(auto& cell : m_cells)
+			cell.clear();
+		m_entries.clear();
+		m_freeHandles.clear();
+		m_queryMarks.clear();
+		m_size = 0;
+	}
+
+	const Rect& SpatialGrid::GetBounds(Handle handle) const{
+		return GetEntry(handle).bounds;
+	}
+
+	void SpatialGrid::Query(const Rect& rect, std::vector<Handle>& result) const{
+		if(rect.w <= 0 || rect.h <= 0)
+			return;
+		if(++m_queryStamp == 0){
+			// Wrapped around; old marks could match again.
+			std::fill(m_queryMarks.begin(), m_queryMarks.end(), 0);
+			m_queryStamp = 1;
+		}
+
+		const auto first = result.size();
+		const auto cells = GetCells(rect);
+		for(auto y = cells.y0; y <= cells.y1; ++y){
+			for(auto x = cells.x0; x <= cells.x1; ++x){
+				for(auto handle : m_cells[static_cast<std::size_t>(y) * m_cellsX + x]){
+					// Objects spanning several cells are tested once.
+					if(m_queryMarks[handle] == m_queryStamp)
+						continue;
+					m_queryMarks[handle] = m_queryStamp;
+					if(Intersects(m_entries[handle].bounds, rect))
+						result.push_back(handle);
+				}
+			}
+		}
+		std::sort(result.begin() + first, result.end());
+	}
+
+}
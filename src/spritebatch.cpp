@@ -0,0 +1,145 @@
+#include "spritebatch.h"
+#include "renderer.h"
+#include "texture.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		// Bits of the sort key below the layer.
+		const uint32_t TextureIdLimit = 1u << 24;
+		const std::size_t BlendIdLimit = 256;
+
+	}
+
+	SpriteBatch::SpriteBatch(Renderer& renderer):m_renderer(renderer){
+
+	}
+
+	void SpriteBatch::Draw(Texture& texture, const Rect& srcRect, const Rect& dstRect, int layer, SDL_BlendMode blendMode){
+		Draw(texture, srcRect, dstRect, 0.0f, SDL_FLIP_NONE, layer, blendMode);
+	}
+
+	void SpriteBatch::Draw(Texture& texture, const Rect& srcRect, const Rect& dstRect, float angle, SDL_RendererFlip flip, int layer, SDL_BlendMode blendMode){
+		m_layers.push_back(layer);
+		m_textureIds.push_back(GetTextureId(texture));
+		m_blendIds.push_back(GetBlendId(blendMode));
+		m_srcRects.push_back(srcRect);
+		m_dstRects.push_back(dstRect);
+		m_angles.push_back(angle);
+		m_flips.push_back(static_cast<uint8_t>(flip));
+	}
+
+	uint32_t SpriteBatch::GetTextureId(Texture& texture){
+		// Consecutive sprites mostly share a texture.
+		if(&texture == m_lastTexture)
+			return m_lastTextureId;
+		const auto inserted = m_textureLookup.emplace(&texture, static_cast<uint32_t>(m_textures.size()));
+		if(inserted.second){
+			if(m_textures.size() == TextureIdLimit)
+				throw std::length_error("SpriteBatch: too many textures");
+			m_textures.push_back(&texture);
+		}
+		m_lastTexture = &texture;
+		m_lastTextureId = inserted.first->second;
+		return m_lastTextureId;
+	}
+
+	uint8_t SpriteBatch::GetBlendId(SDL_BlendMode blendMode){
+		const auto it = std::find(m_blendModes.begin(), m_blendModes.end(), blendMode);
+		if(it != m_blendModes.end())
+			return static_cast<uint8_t>(it - m_blendModes.begin());
+		if(m_blendModes.size() == BlendIdLimit)
+			throw std::length_error("SpriteBatch: too many blend modes");
+		m_blendModes.push_back(blendMode);
+		return static_cast<uint8_t>(m_blendModes.size() - 1);
+	}
+
+	void SpriteBatch::Flush(){
+		const auto count = static_cast<uint32_t>(GetSize());
+		m_order.resize(count);
+		for(uint32_t i = 0; i < count; ++i){
+			// Flipping the sign bit makes signed layers sort as unsigned.
+			const auto layer = static_cast<uint32_t>(m_layers[i]) ^ 0x80000000u;
+			m_order[i] = SortEntry{static_cast<uint64_t>(layer) << 32 | static_cast<uint64_t>(m_textureIds[i]) << 8 | m_blendIds[i], i};
+		}
+		std::sort(m_order.begin(), m_order.end());
+
+		Stats stats;
+		stats.sprites = count;
+		// Blend mode last set on each texture during this flush.
+		std::vector<int> textureBlend(m_textures.size(), -1);
+		auto currentTexture = TextureIdLimit;
+		try{
+			for(std::size_t first = 0; first < m_order.size();){
+				const auto index = m_order[first].index;
+				const auto textureId = m_textureIds[index];
+				const auto blendId = m_blendIds[index];
+				auto& texture = *m_textures[textureId];
+
+				if(textureBlend[textureId] != blendId){
+					if(textureBlend[textureId] != -1 || texture.GetTextureBlendMode() != m_blendModes[blendId]){
+						// Recorded copies, including those queued before this
+						// flush, pick up the texture's blend mode only when they
+						// are submitted.
+						if(m_renderer.IsCommandBufferEnabled())
+							m_renderer.FlushCommandBuffer();
+						texture.SetTextureBlendMode(m_blendModes[blendId]);
+						++stats.blendModeChanges;
+					}
+					textureBlend[textureId] = blendId;
+				}
+				if(textureId != currentTexture){
+					currentTexture = textureId;
+					++stats.textureSwitches;
+				}
+
+				if(IsTransformed(index)){
+					m_renderer.RenderCopyEx(texture, m_srcRects[index], m_dstRects[index], m_angles[index], nullptr, static_cast<SDL_RendererFlip>(m_flips[index]));
+					++stats.batches;
+					++first;
+					continue;
+				}
+
+				// Gather the run of plain sprites with the same texture and
+				// blend mode, which may span several layers.
+				m_runSrcRects.clear();
+				m_runDstRects.clear();
+				auto last = first;
+				for(; last < m_order.size(); ++last){
+					const auto other = m_order[last].index;
+					if(m_textureIds[other] != textureId || m_blendIds[other] != blendId || IsTransformed(other))
+						break;
+					m_runSrcRects.push_back(m_srcRects[other]);
+					m_runDstRects.push_back(m_dstRects[other]);
+				}
+				m_renderer.RenderCopies(texture, m_runSrcRects, m_runDstRects);
+				++stats.batches;
+				first = last;
+			}
+		}catch(...){
+			Clear();
+			throw;
+		}
+
+		m_lastStats = stats;
+		Clear();
+	}
+
+	void SpriteBatch::Clear(){
+		m_layers.clear();
+		m_textureIds.clear();
+		m_blendIds.clear();
+		m_srcRects.clear();
+		m_dstRects.clear();
+		m_angles.clear();
+		m_flips.clear();
+		m_textures.clear();
+		m_textureLookup.clear();
+		m_lastTexture = nullptr;
+		m_blendModes.clear();
+	}
+
+}
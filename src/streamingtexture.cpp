@@ -0,0 +1,62 @@
+#include "streamingtexture.h"
+#include "renderer.h"
+#include "texture.h"
+#include <SDL_render.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace SDL{
+
+	StreamingTexture::StreamingTexture(Renderer& renderer, uint32_t format, int w, int h, bool doubleBuffered):
+		m_width(w),
+		m_height(h),
+		m_bytesPerPixel(SDL_BYTESPERPIXEL(format)){
+		if(SDL_ISPIXELFORMAT_FOURCC(format) || m_bytesPerPixel == 0)
+			throw std::invalid_argument("StreamingTexture: packed pixel format required");
+		if(w <= 0 || h <= 0)
+			throw std::invalid_argument("StreamingTexture: invalid size");
+
+		m_pitch = (w * m_bytesPerPixel + 3) & ~3;
+		m_pixels.resize(static_cast<std::size_t>(m_pitch) * h);
+
+		const auto count = doubleBuffered ? 2 : 1;
+		for(auto i = 0; i < count; ++i){
+			m_textures.push_back(renderer.CreateTexture(format, SDL_TEXTUREACCESS_STREAMING, w, h));
+			m_dirty.emplace_back(w, h);
+			m_dirty.back().AddAll();
+		}
+	}
+
+	StreamingTexture::~StreamingTexture(){
+
+	}
+
+	void StreamingTexture::MarkDirty(const Rect& rect){
+		for(auto& dirty : m_dirty)
+			dirty.Add(rect);
+	}
+
+	void StreamingTexture::MarkDirty(){
+		for(auto& dirty : m_dirty)
+			dirty.AddAll();
+	}
+
+	std::shared_ptr<Texture> StreamingTexture::Upload(){
+		const auto back = (m_front + 1) % m_textures.size();
+		Upload(*m_textures[back], m_dirty[back]);
+		m_dirty[back].Clear();
+		m_front = back;
+		return m_textures[m_front];
+	}
+
+	void StreamingTexture::Upload(Texture& texture, const DirtyRects& dirty){
+		for(const auto& rect : dirty.GetRects()){
+			auto lock = texture.LockTexture(rect);
+			const auto rowBytes = static_cast<std::size_t>(rect.w) * m_bytesPerPixel;
+			const auto* source = m_pixels.data() + rect.y * m_pitch + rect.x * m_bytesPerPixel;
+			for(auto y = 0; y < rect.h; ++y)
+				std::memcpy(lock.GetRow(y), source + y * m_pitch, rowBytes);
+		}
+	}
+
+}
@@ -1,4 +1,6 @@
 #include "texture.h"
+#include "error.h"
+#include "profiler.h"
 #include <SDL_render.h>
 
 
@@ -8,8 +10,8 @@ namespace SDL{
 		/*STUB*/
 	}
 
-	Texture::Texture(SDL_Texture*){
-		/*STUB*/
+	Texture::Texture(SDL_Texture* texture):m_texture(texture){
+
 	}
 
 	Texture::~Texture(){
@@ -22,10 +24,79 @@ namespace SDL{
 		m_texture = nullptr;
 	}
 
-	// extern DECLSPEC int SDL_QueryTexture(SDL_Texture * texture,
-	//                                              uint32_t * format, int *access,
-	//                                              int *w, int *h);
-	// 
+	Texture::Info Texture::QueryTexture() const{
+		Info info;
+		if(SDL_QueryTexture(m_texture, &info.format, &info.access, &info.w, &info.h) != 0)
+			throw Error();
+		return info;
+	}
+
+	void Texture::SetTextureBlendMode(SDL_BlendMode blendMode){
+		if(SDL_SetTextureBlendMode(m_texture, blendMode) != 0)
+			throw Error();
+	}
+
+	SDL_BlendMode Texture::GetTextureBlendMode() const{
+		SDL_BlendMode blendMode;
+		if(SDL_GetTextureBlendMode(m_texture, &blendMode) != 0)
+			throw Error();
+		return blendMode;
+	}
+
+	void Texture::UpdateTexture(const Rect& rect, const void* pixels, int pitch){
+		SDL2PP_PROFILE_ZONE(UpdateTexture);
+		if(SDL_UpdateTexture(m_texture, &rect, pixels, pitch) != 0)
+			throw Error();
+	}
+
+	void Texture::UpdateTexture(const void* pixels, int pitch){
+		SDL2PP_PROFILE_ZONE(UpdateTexture);
+		if(SDL_UpdateTexture(m_texture, nullptr, pixels, pitch) != 0)
+			throw Error();
+	}
+
+	void Texture::UpdateYUVTexture(const Rect& rect, const uint8_t* yPlane, int yPitch, const uint8_t* uPlane, int uPitch, const uint8_t* vPlane, int vPitch){
+		SDL2PP_PROFILE_ZONE(UpdateTexture);
+		if(SDL_UpdateYUVTexture(m_texture, &rect, yPlane, yPitch, uPlane, uPitch, vPlane, vPitch) != 0)
+			throw Error();
+	}
+
+	void Texture::UpdateYUVTexture(const uint8_t* yPlane, int yPitch, const uint8_t* uPlane, int uPitch, const uint8_t* vPlane, int vPitch){
+		SDL2PP_PROFILE_ZONE(UpdateTexture);
+		if(SDL_UpdateYUVTexture(m_texture, nullptr, yPlane, yPitch, uPlane, uPitch, vPlane, vPitch) != 0)
+			throw Error();
+	}
+
+	Texture::Lock::Lock(Texture& texture, const Rect* rect):m_texture(texture.Get()){
+		SDL2PP_PROFILE_ZONE(LockTexture);
+		if(SDL_LockTexture(m_texture, rect, &m_pixels, &m_pitch) != 0)
+			throw Error();
+	}
+
+	Texture::Lock::Lock(Lock&& other):m_texture(other.m_texture), m_pixels(other.m_pixels), m_pitch(other.m_pitch){
+		other.m_texture = nullptr;
+		other.m_pixels = nullptr;
+	}
+
+	Texture::Lock::~Lock(){
+		Unlock();
+	}
+
+	void Texture::Lock::Unlock(){
+		if(m_texture != nullptr && m_pixels != nullptr)
+			SDL_UnlockTexture(m_texture);
+		m_texture = nullptr;
+		m_pixels = nullptr;
+	}
+
+	Texture::Lock Texture::LockTexture(const Rect& rect){
+		return Lock(*this, &rect);
+	}
+
+	Texture::Lock Texture::LockTexture(){
+		return Lock(*this, nullptr);
+	}
+
 	// extern DECLSPEC int SDL_SetTextureColorMod(SDL_Texture * texture,
 	//                                                    uint8_t r, uint8_t g, uint8_t b);
 	// 
@@ -40,28 +111,9 @@ namespace SDL{
 	// extern DECLSPEC int SDL_GetTextureAlphaMod(SDL_Texture * texture,
 	//                                                    uint8_t * alpha);
 	// 
-	// extern DECLSPEC int SDL_SetTextureBlendMode(SDL_Texture * texture,
-	//                                                     SDL_BlendMode blendMode);
-	// 
 	// extern DECLSPEC int SDL_GetTextureBlendMode(SDL_Texture * texture,
 	//                                                     SDL_BlendMode *blendMode);
 	// 
-	// extern DECLSPEC int SDL_UpdateTexture(SDL_Texture * texture,
-	//                                               const SDL_Rect * rect,
-	//                                               const void *pixels, int pitch);
-	// 
-	// extern DECLSPEC int SDL_UpdateYUVTexture(SDL_Texture * texture,
-	//                                                  const SDL_Rect * rect,
-	//                                                  const uint8_t *Yplane, int Ypitch,
-	//                                                  const uint8_t *Uplane, int Upitch,
-	//                                                  const uint8_t *Vplane, int Vpitch);
-	// 
-	// extern DECLSPEC int SDL_LockTexture(SDL_Texture * texture,
-	//                                             const SDL_Rect * rect,
-	//                                             void **pixels, int *pitch);
-	// 
-	// extern DECLSPEC void SDL_UnlockTexture(SDL_Texture * texture);
-	// 
 	// extern DECLSPEC int SDL_GL_BindTexture(SDL_Texture *texture, float *texw, float *texh);
 	// 
 	// extern DECLSPEC int SDL_GL_UnbindTexture(SDL_Texture *texture);
@@ -0,0 +1,161 @@
+#include "texturepool.h"
+#include "texture.h"
+#include <SDL_render.h>
+#include <functional>
+
+namespace SDL{
+
+	std::size_t TexturePool::KeyHash::operator()(const Key& key) const{
+		auto hash = std::hash<uint32_t>()(key.format);
+		hash = hash * 31 + std::hash<int>()(key.access);
+		hash = hash * 31 + std::hash<int>()(key.w);
+		hash = hash * 31 + std::hash<int>()(key.h);
+		return hash;
+	}
+
+	TexturePool::TexturePool(std::size_t budgetBytes):m_budget(budgetBytes){
+
+	}
+
+	TexturePool::~TexturePool(){
+		Clear();
+	}
+
+	std::size_t TexturePool::GetTextureBytes(const Key& key){
+		const auto pixels = static_cast<std::size_t>(key.w) * key.h;
+		// Planar YUV formats report one byte per pixel for the Y plane.
+		if(SDL_ISPIXELFORMAT_FOURCC(key.format) && SDL_BYTESPERPIXEL(key.format) == 1)
+			return pixels + pixels / 2;
+		return pixels * SDL_BYTESPERPIXEL(key.format);
+	}
+
+	std::shared_ptr<Texture> TexturePool::Acquire(const Key& key){
+		SDL_Texture* texture = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			CollectLocked();
+			auto bucket = m_buckets.find(key);
+			if(bucket == m_buckets.end() || bucket->second.empty()){
+				++m_stats.misses;
+				return nullptr;
+			}
+			// Most recently released first, its memory is the likeliest to be warm.
+			auto idle = bucket->second.back();
+			bucket->second.pop_back();
+			texture = idle->texture;
+			m_stats.idleBytes -= idle->bytes;
+			--m_stats.idleTextures;
+			m_idle.erase(idle);
+			++m_stats.hits;
+		}
+		return Wrap(texture, key);
+	}
+
+	std::shared_ptr<Texture> TexturePool::Adopt(SDL_Texture* texture, const Key& key){
+		return Wrap(texture, key);
+	}
+
+	std::shared_ptr<Texture> TexturePool::Wrap(SDL_Texture* texture, const Key& key){
+		std::weak_ptr<TexturePool> weakPool = shared_from_this();
+		auto rendererAlive = m_rendererAlive;
+		return std::shared_ptr<Texture>(new Texture(texture), [weakPool, rendererAlive, key](Texture* wrapper){
+			auto* sdlTexture = wrapper->Release();
+			delete wrapper;
+			if(sdlTexture == nullptr || !*rendererAlive)
+				return;
+			auto pool = weakPool.lock();
+			if(pool)
+				pool->Release(sdlTexture, key);
+			else
+				SDL_DestroyTexture(sdlTexture);
+		});
+	}
+
+	void TexturePool::Release(SDL_Texture* texture, const Key& key){
+		// Any thread; SDL is only called from Collect().
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if(!*m_rendererAlive)
+			return;
+		m_released.push_back(Idle{key, texture, GetTextureBytes(key)});
+	}
+
+	void TexturePool::Collect(){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		CollectLocked();
+	}
+
+	void TexturePool::CollectLocked(){
+		if(m_released.empty())
+			return;
+		for(const auto& released : m_released){
+			auto* texture = released.texture;
+			if(released.bytes > m_budget){
+				SDL_DestroyTexture(texture);
+				++m_stats.evicted;
+				continue;
+			}
+			SDL_SetTextureColorMod(texture, 255, 255, 255);
+			SDL_SetTextureAlphaMod(texture, 255);
+			SDL_SetTextureBlendMode(texture, SDL_ISPIXELFORMAT_ALPHA(released.key.format) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+			m_idle.push_back(released);
+			m_buckets[released.key].push_back(std::prev(m_idle.end()));
+			m_stats.idleBytes += released.bytes;
+			++m_stats.idleTextures;
+			++m_stats.recycled;
+		}
+		m_released.clear();
+		TrimLocked(m_budget);
+	}
+
+	void TexturePool::MarkRendererDestroyed(){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		CollectLocked();
+		TrimLocked(0);
+		*m_rendererAlive = false;
+	}
+
+	void TexturePool::SetBudget(std::size_t budgetBytes){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_budget = budgetBytes;
+		CollectLocked();
+		TrimLocked(m_budget);
+	}
+
+	void TexturePool::Trim(std::size_t targetBytes){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		CollectLocked();
+		TrimLocked(targetBytes);
+	}
+
+	void TexturePool::TrimLocked(std::size_t targetBytes){
+		while(m_stats.idleBytes > targetBytes && !m_idle.empty()){
+			auto oldest = m_idle.begin();
+			auto& bucket = m_buckets[oldest->key];
+			for(auto it = bucket.begin(); it != bucket.end(); ++it){
+				if(*it == oldest){
+					bucket.erase(it);
+					break;
+				}
+			}
+			SDL_DestroyTexture(oldest->texture);
+			m_stats.idleBytes -= oldest->bytes;
+			--m_stats.idleTextures;
+			++m_stats.evicted;
+			m_idle.erase(oldest);
+		}
+	}
+
+	TexturePool::Stats TexturePool::GetStats() const{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_stats;
+	}
+
+	void TexturePool::ResetStats(){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.hits = 0;
+		m_stats.misses = 0;
+		m_stats.recycled = 0;
+		m_stats.evicted = 0;
+	}
+
+}
@@ -0,0 +1,113 @@
+#include "threadpool.h"
+#include <SDL_cpuinfo.h>
+#include <algorithm>
+
+namespace SDL{
+
+	ThreadPool::ThreadPool(unsigned threads){
+		if(threads == 0)
+			threads = static_cast<unsigned>(std::max(SDL_GetCPUCount(), 1));
+		for(unsigned i = 0; i < threads; ++i)
+			m_queues.push_back(std::make_unique<Queue>());
+		for(unsigned i = 1; i < threads; ++i)
+			m_threads.emplace_back(&ThreadPool::Work, this, i);
+	}
+
+	ThreadPool::~ThreadPool(){
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for(auto& thread : m_threads)
+			thread.join();
+	}
+
+	void ThreadPool::Run(std::size_t count, const Task& task){
+		if(count == 0)
+			return;
+		const auto threads = m_queues.size();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_task = &task;
+			m_error = nullptr;
+			m_remaining = count;
+			// Contiguous blocks keep neighbouring indices, e.g. adjacent
+			// tiles, on one thread.
+			for(std::size_t thread = 0; thread < threads; ++thread){
+				auto& queue = *m_queues[thread];
+				std::lock_guard<std::mutex> queueLock(queue.mutex);
+				for(auto index = thread * count / threads; index < (thread + 1) * count / threads; ++index)
+					queue.indices.push_back(index);
+			}
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		std::size_t index;
+		while(Pop(0, index))
+			Execute(index, 0);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]{ return m_remaining == 0; });
+		m_task = nullptr;
+		if(m_error)
+			std::rethrow_exception(m_error);
+	}
+
+	void ThreadPool::Work(unsigned thread){
+		uint64_t generation = 0;
+		for(;;){
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [&]{ return m_stop || m_generation != generation; });
+				if(m_stop)
+					return;
+				generation = m_generation;
+			}
+			std::size_t index;
+			while(Pop(thread, index))
+				Execute(index, thread);
+		}
+	}
+
+	bool ThreadPool::Pop(unsigned thread, std::size_t& index){
+		{
+			auto& own = *m_queues[thread];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if(!own.indices.empty()){
+				index = own.indices.front();
+				own.indices.pop_front();
+				return true;
+			}
+		}
+		// Steal from the end of the others' blocks, away from where their
+		// owners are working.
+		const auto threads = m_queues.size();
+		for(std::size_t i = 1; i < threads; ++i){
+			auto& victim = *m_queues[(thread + i) % threads];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if(!victim.indices.empty()){
+				index = victim.indices.back();
+				victim.indices.pop_back();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::Execute(std::size_t index, unsigned thread){
+		try{
+			(*m_task)(index, thread);
+		}catch(...){
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if(!m_error)
+				m_error = std::current_exception();
+		}
+		if(--m_remaining == 0){
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_done.notify_all();
+		}
+	}
+
+}
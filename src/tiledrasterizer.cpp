@@ -0,0 +1,177 @@
+#include "tiledrasterizer.h"
+#include <SDL_surface.h>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace SDL{
+
+	namespace{
+
+		// Bounding box of the pixels a segment can touch.
+		Rect SegmentBounds(const Point& a, const Point& b, const Rect& viewport){
+			return Rect{std::min(a.x, b.x) + viewport.x, std::min(a.y, b.y) + viewport.y, std::abs(a.x - b.x) + 1, std::abs(a.y - b.y) + 1};
+		}
+
+		uint32_t PackColor(const RenderCommandBuffer::Color& color){
+			return color.r | color.g << 8 | color.b << 16 | static_cast<uint32_t>(color.a) << 24;
+		}
+
+	}
+
+	bool TiledRasterizer::Supports(const SDL_Surface* surface){
+		return SurfaceRasterizer::Supports(surface) && !SDL_MUSTLOCK(surface);
+	}
+
+	TiledRasterizer::TiledRasterizer(SDL_Surface* surface, int tileSize, unsigned threads)
+		:m_tileSize(tileSize), m_tilesX(0), m_tilesY(0), m_rasterizer(surface), m_pool(threads){
+		if(tileSize <= 0)
+			throw std::invalid_argument("TiledRasterizer: tile size must be positive");
+		if(!Supports(surface))
+			throw std::invalid_argument("TiledRasterizer: surface must not need locking");
+		m_tilesX = (surface->w + tileSize - 1) / tileSize;
+		m_tilesY = (surface->h + tileSize - 1) / tileSize;
+		m_bins.resize(static_cast<std::size_t>(m_tilesX) * m_tilesY);
+		m_threadRasterizers.assign(m_pool.GetThreadCount(), m_rasterizer);
+	}
+
+	int TiledRasterizer::Draw(const RenderCommandBuffer& buffer, std::size_t first, std::size_t last){
+		for(auto& bin : m_bins)
+			bin.clear();
+		Bin(buffer, first, last);
+
+		m_activeTiles.clear();
+		for(std::size_t tile = 0; tile < m_bins.size(); ++tile){
+			if(!m_bins[tile].empty())
+				m_activeTiles.push_back(tile);
+		}
+		for(auto& rasterizer : m_threadRasterizers)
+			rasterizer = m_rasterizer;
+		m_tileResults.assign(m_activeTiles.size(), 0);
+
+		m_pool.Run(m_activeTiles.size(), [&](std::size_t index, unsigned thread){
+			m_tileResults[index] = DrawTile(buffer, m_activeTiles[index], m_threadRasterizers[thread]);
+		});
+
+		for(auto result : m_tileResults){
+			if(result != 0)
+				return result;
+		}
+		return 0;
+	}
+
+	void TiledRasterizer::Bin(const RenderCommandBuffer& buffer, std::size_t first, std::size_t last){
+		const auto& commands = buffer.GetCommands();
+		const auto& viewport = m_rasterizer.GetViewport();
+		const auto& visible = m_rasterizer.GetVisibleRect();
+
+		for(auto index = first; index < last; ++index){
+			const auto& command = commands[index];
+			const auto c = static_cast<uint32_t>(index);
+			switch(command.type){
+				case RenderCommandBuffer::Type::Clear:
+					BinAll(c);
+					break;
+				case RenderCommandBuffer::Type::Points:{
+					const auto* points = buffer.GetPoints(command);
+					for(uint32_t i = 0; i < command.count; ++i)
+						BinRect(c, i, SegmentBounds(points[i], points[i], viewport), visible);
+					break;
+				}
+				case RenderCommandBuffer::Type::Lines:{
+					const auto* points = buffer.GetPoints(command);
+					if(command.count == 1)
+						BinRect(c, 0, SegmentBounds(points[0], points[0], viewport), visible);
+					for(uint32_t i = 0; i + 1 < command.count; ++i)
+						BinRect(c, i, SegmentBounds(points[i], points[i + 1], viewport), visible);
+					break;
+				}
+				case RenderCommandBuffer::Type::Rects:{
+					const auto* rects = buffer.GetRects(command);
+					for(uint32_t i = 0; i < command.count; ++i){
+						const Point corner{rects[i].x, rects[i].y};
+						const Point opposite{rects[i].x + rects[i].w - 1, rects[i].y + rects[i].h - 1};
+						BinRect(c, i, SegmentBounds(corner, opposite, viewport), visible);
+					}
+					break;
+				}
+				case RenderCommandBuffer::Type::FillRects:{
+					const auto* rects = buffer.GetRects(command);
+					for(uint32_t i = 0; i < command.count; ++i)
+						BinRect(c, i, Rect{rects[i].x + viewport.x, rects[i].y + viewport.y, rects[i].w, rects[i].h}, visible);
+					break;
+				}
+				case RenderCommandBuffer::Type::Copy:
+					throw std::logic_error("TiledRasterizer: copies have to be submitted to SDL");
+			}
+		}
+	}
+
+	void TiledRasterizer::BinAll(uint32_t command){
+		for(auto& bin : m_bins)
+			bin.push_back(Entry{command, 0, 1});
+	}
+
+	void TiledRasterizer::BinRect(uint32_t command, uint32_t primitive, Rect rect, const Rect& visible){
+		if(!SDL_IntersectRect(&rect, &visible, &rect))
+			return;
+		const auto x0 = rect.x / m_tileSize;
+		const auto y0 = rect.y / m_tileSize;
+		const auto x1 = (rect.x + rect.w - 1) / m_tileSize;
+		const auto y1 = (rect.y + rect.h - 1) / m_tileSize;
+		for(auto y = y0; y <= y1; ++y){
+			for(auto x = x0; x <= x1; ++x){
+				auto& bin = m_bins[static_cast<std::size_t>(y) * m_tilesX + x];
+				// Runs of primitives of one command share an entry.
+				if(!bin.empty() && bin.back().command == command && bin.back().first + bin.back().count == primitive)
+					++bin.back().count;
+				else
+					bin.push_back(Entry{command, primitive, 1});
+			}
+		}
+	}
+
+	int TiledRasterizer::DrawTile(const RenderCommandBuffer& buffer, std::size_t tile, SurfaceRasterizer& rasterizer){
+		const auto tileX = static_cast<int>(tile % m_tilesX);
+		const auto tileY = static_cast<int>(tile / m_tilesX);
+		const Rect bounds{tileX * m_tileSize, tileY * m_tileSize, m_tileSize, m_tileSize};
+		rasterizer.SetBounds(&bounds);
+
+		const auto& commands = buffer.GetCommands();
+		auto colorSet = false;
+		uint32_t color = 0;
+		for(const auto& entry : m_bins[tile]){
+			const auto& command = commands[entry.command];
+			if(!colorSet || PackColor(command.color) != color){
+				rasterizer.SetDrawColor(command.color.r, command.color.g, command.color.b, command.color.a);
+				color = PackColor(command.color);
+				colorSet = true;
+			}
+
+			auto result = 0;
+			switch(command.type){
+				case RenderCommandBuffer::Type::Clear:
+					result = rasterizer.Clear();
+					break;
+				case RenderCommandBuffer::Type::Points:
+					result = rasterizer.DrawPoints(buffer.GetPoints(command) + entry.first, entry.count);
+					break;
+				case RenderCommandBuffer::Type::Lines:
+					result = rasterizer.DrawLines(buffer.GetPoints(command), command.count, entry.first, entry.count);
+					break;
+				case RenderCommandBuffer::Type::Rects:
+					result = rasterizer.DrawRects(buffer.GetRects(command) + entry.first, entry.count);
+					break;
+				case RenderCommandBuffer::Type::FillRects:
+					result = rasterizer.FillRects(buffer.GetRects(command) + entry.first, entry.count);
+					break;
+				case RenderCommandBuffer::Type::Copy:
+					break;
+			}
+			if(result != 0)
+				return result;
+		}
+		return 0;
+	}
+
+}
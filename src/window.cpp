@@ -0,0 +1,150 @@
+#include "window.h"
+#include "error.h"
+#include <SDL_render.h>
+#include <SDL_surface.h>
+#include <SDL_video.h>
+#include <stdexcept>
+
+namespace SDL{
+
+	Window::Window(){
+		/*STUB*/
+	}
+
+	Window::Window(SDL_Window* window):m_window(window){
+
+	}
+
+	Window::Window(SDL_Window* window, SDL_Renderer* renderer):m_window(window){
+		m_renderer = std::make_shared<Renderer>(renderer);
+	}
+
+	Window::Window(std::string title, Rect dimension, uint32_t flags){
+		m_window = SDL_CreateWindow(title.c_str(), dimension.x, dimension.y, dimension.w, dimension.h, flags);
+		if(m_window == nullptr)
+			throw Error();
+	}
+
+	Window::~Window(){
+		// The renderer has to go before the window it draws into.
+		m_renderer.reset();
+		SDL_DestroyWindow(m_window);
+	}
+
+	std::pair<std::shared_ptr<Window>, std::shared_ptr<Renderer>> Window::CreateWindowAndRenderer(int width, int height, uint32_t window_flags){
+		SDL_Renderer* renderer = nullptr;
+		SDL_Window* sdlWindow = nullptr;
+		if(SDL_CreateWindowAndRenderer(width, height, window_flags, &sdlWindow, &renderer) != 0)
+			throw Error();
+		auto window = std::make_shared<Window>(sdlWindow, renderer);
+		return std::make_pair(window, window->GetRenderer());
+	}
+
+	std::shared_ptr<Renderer> Window::CreateRenderer(int index, uint32_t flags){
+		auto* sdlRenderer = SDL_CreateRenderer(m_window, index, flags);
+		if(sdlRenderer == nullptr)
+			throw Error();
+		m_renderer = std::make_shared<Renderer>(sdlRenderer);
+		return m_renderer;
+	}
+
+	glm::ivec2 Window::GetWindowSize(){
+		glm::ivec2 size;
+		SDL_GetWindowSize(m_window, &size.x, &size.y);
+		return size;
+	}
+
+	SDL_DisplayMode Window::GetWindowDisplayMode(){
+		SDL_DisplayMode mode;
+		if(SDL_GetWindowDisplayMode(m_window, &mode) != 0)
+			throw Error();
+		return mode;
+	}
+
+	void Window::GL_SetSwapInterval(int interval){
+		GL_SetSwapInterval(interval, std::nothrow).ThrowIfFailed();
+	}
+
+	Result Window::GL_SetSwapInterval(int interval, const std::nothrow_t&){
+		return Result(SDL_GL_SetSwapInterval(interval));
+	}
+
+	int Window::GL_GetSwapInterval(){
+		return SDL_GL_GetSwapInterval();
+	}
+
+	SDL_Surface* Window::GetWindowSurface(){
+		auto* surface = SDL_GetWindowSurface(m_window);
+		if(surface == nullptr)
+			throw Error();
+		return surface;
+	}
+
+	std::shared_ptr<Renderer> Window::CreateSurfaceRenderer(SoftwareBackend backend){
+		// Drop the old renderer first, it may still point at the surface SDL
+		// is about to replace.
+		m_renderer.reset();
+		m_renderer = Renderer::CreateSoftwareRenderer(GetWindowSurface(), backend);
+		return m_renderer;
+	}
+
+	void Window::UpdateWindowSurface(){
+		if(SDL_UpdateWindowSurface(m_window) != 0)
+			throw Error();
+	}
+
+	void Window::UpdateWindowSurfaceRects(Span<const Rect> rects){
+		if(rects.empty())
+			return;
+		if(SDL_UpdateWindowSurfaceRects(m_window, rects.data(), static_cast<int>(rects.size())) != 0)
+			throw Error();
+	}
+
+	Window::SurfaceLock::SurfaceLock(Window& window):m_surface(window.GetWindowSurface()){
+		if(SDL_MUSTLOCK(m_surface)){
+			if(SDL_LockSurface(m_surface) != 0)
+				throw Error();
+			m_locked = true;
+		}
+		m_pixels = m_surface->pixels;
+		m_width = m_surface->w;
+		m_height = m_surface->h;
+		m_pitch = m_surface->pitch;
+	}
+
+	Window::SurfaceLock::SurfaceLock(SurfaceLock&& other):m_surface(other.m_surface), m_pixels(other.m_pixels), m_width(other.m_width), m_height(other.m_height), m_pitch(other.m_pitch), m_locked(other.m_locked){
+		other.m_surface = nullptr;
+		other.m_pixels = nullptr;
+		other.m_locked = false;
+	}
+
+	Window::SurfaceLock::~SurfaceLock(){
+		Unlock();
+	}
+
+	void Window::SurfaceLock::Unlock(){
+		if(m_locked)
+			SDL_UnlockSurface(m_surface);
+		m_surface = nullptr;
+		m_pixels = nullptr;
+		m_locked = false;
+	}
+
+	uint32_t Window::SurfaceLock::GetFormat() const{
+		if(m_surface == nullptr)
+			throw std::logic_error("Window::SurfaceLock: not locked");
+		return m_surface->format->format;
+	}
+
+	void Window::SurfaceLock::CheckPixelSize(std::size_t size) const{
+		if(m_surface == nullptr)
+			throw std::logic_error("Window::SurfaceLock: not locked");
+		if(size != m_surface->format->BytesPerPixel)
+			throw std::logic_error("Window::SurfaceLock: pixel type does not match the surface format");
+	}
+
+	Window::SurfaceLock Window::LockWindowSurface(){
+		return SurfaceLock(*this);
+	}
+
+}
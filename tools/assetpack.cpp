@@ -0,0 +1,285 @@
+#include "assetarchive.h"
+#include "atlas.h"
+#include "error.h"
+#include "imageasset.h"
+#include "mappedfile.h"
+#include "pixelconvert.h"
+
+#include <SDL_pixels.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Packs BMP and QOI files into one archive for SDL::AssetArchive.
+//
+//   SDL2++_assetpack [--format=FORMAT] [--align=BYTES] [--atlas=WIDTHxHEIGHT]
+//                    [--padding=PIXELS] OUTPUT INPUT...
+//
+// The pixels are stored in FORMAT (argb8888 by default, the format most
+// renderers list first), so pick the one the target renderer reports. With
+// --atlas, inputs that fit are packed into pages of that size; the rest are
+// stored as images of their own. Every input becomes a sprite named by its
+// path as given on the command line.
+
+namespace{
+
+    struct Options{
+        uint32_t format = SDL_PIXELFORMAT_ARGB8888;
+        bool formatAlpha = true;
+        uint32_t alignment = 64;
+        int atlasWidth = 0;
+        int atlasHeight = 0;
+        int padding = 1;
+        std::string output;
+        std::vector<std::string> inputs;
+    };
+
+    struct Format{
+        const char* name;
+        uint32_t format;
+        bool alpha;
+    };
+
+    const Format formats[] = {
+        {"argb8888", SDL_PIXELFORMAT_ARGB8888, true},
+        {"rgba8888", SDL_PIXELFORMAT_RGBA8888, true},
+        {"abgr8888", SDL_PIXELFORMAT_ABGR8888, true},
+        {"bgra8888", SDL_PIXELFORMAT_BGRA8888, true},
+        {"rgb888", SDL_PIXELFORMAT_RGB888, false},
+        {"bgr888", SDL_PIXELFORMAT_BGR888, false},
+        {"rgb565", SDL_PIXELFORMAT_RGB565, false}
+    };
+
+    // Decoded ARGB8888 pixels.
+    struct Picture{
+        std::string name;
+        int width;
+        int height;
+        bool alpha;
+        std::vector<uint32_t> pixels;
+    };
+
+    struct Sprite{
+        std::string name;
+        std::size_t image;
+        SDL::Rect rect;
+    };
+
+    Picture Load(const std::string& path){
+        const SDL::ImageAsset asset(std::make_shared<const SDL::MappedFile>(path));
+        Picture picture{path, asset.GetWidth(), asset.GetHeight(), asset.HasAlpha(), {}};
+        picture.pixels.resize(static_cast<std::size_t>(picture.width) * picture.height);
+        asset.Decode(picture.pixels.data(), picture.width * 4);
+        return picture;
+    }
+
+    // Copies source to x, y and fills the padding around it with its edge
+    // pixels, so linear filtering at the sprite's border stays inside it.
+    void Blit(const Picture& source, Picture& target, int x, int y, int padding){
+        for(auto row = -padding; row < source.height + padding; ++row){
+            const auto* line = source.pixels.data() + std::min(std::max(row, 0), source.height - 1) * source.width;
+            auto* out = target.pixels.data() + (y + row) * target.width + x;
+            std::fill(out - padding, out, line[0]);
+            std::copy_n(line, source.width, out);
+            std::fill(out + source.width, out + source.width + padding, line[source.width - 1]);
+        }
+    }
+
+    // Fills pages with the inputs, tallest first, and appends the inputs
+    // that do not fit any page as images of their own.
+    void PackAtlas(const Options& options, std::vector<Picture>& inputs, std::vector<Picture>& images, std::vector<Sprite>& sprites){
+        std::vector<std::size_t> order(inputs.size());
+        for(std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return inputs[a].height > inputs[b].height; });
+
+        std::vector<SDL::SkylinePacker> packers;
+        // Input and sprite index of the sprites on each page.
+        std::vector<std::vector<std::pair<std::size_t, std::size_t>>> pageSprites;
+        std::vector<std::size_t> standalone;
+        for(auto index : order){
+            auto& input = inputs[index];
+            const auto w = input.width + 2 * options.padding;
+            const auto h = input.height + 2 * options.padding;
+            if(w > options.atlasWidth || h > options.atlasHeight){
+                standalone.push_back(index);
+                continue;
+            }
+            SDL::Rect rect;
+            std::size_t page = 0;
+            while(page < packers.size() && !packers[page].Insert(w, h, rect))
+                ++page;
+            if(page == packers.size()){
+                packers.emplace_back(options.atlasWidth, options.atlasHeight);
+                pageSprites.emplace_back();
+                packers.back().Insert(w, h, rect);
+            }
+            pageSprites[page].emplace_back(index, sprites.size());
+            sprites.push_back(Sprite{input.name, page, SDL::Rect{rect.x + options.padding, rect.y + options.padding, input.width, input.height}});
+        }
+
+        for(std::size_t page = 0; page < packers.size(); ++page){
+            // Pages are cut below their lowest sprite.
+            auto height = 0;
+            for(const auto& entry : pageSprites[page])
+                height = std::max(height, sprites[entry.second].rect.y + sprites[entry.second].rect.h + options.padding);
+            Picture picture{"#atlas" + std::to_string(page), options.atlasWidth, height, false, {}};
+            picture.pixels.assign(static_cast<std::size_t>(picture.width) * picture.height, 0);
+            for(const auto& entry : pageSprites[page]){
+                const auto& input = inputs[entry.first];
+                Blit(input, picture, sprites[entry.second].rect.x, sprites[entry.second].rect.y, options.padding);
+                picture.alpha = picture.alpha || input.alpha;
+            }
+            images.push_back(std::move(picture));
+        }
+        for(auto index : standalone){
+            sprites.push_back(Sprite{inputs[index].name, images.size(), SDL::Rect{0, 0, inputs[index].width, inputs[index].height}});
+            images.push_back(std::move(inputs[index]));
+        }
+    }
+
+    uint64_t Align(uint64_t offset, uint32_t alignment){
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    void Write(const Options& options, std::vector<Picture>& images, std::vector<Sprite>& sprites){
+        // Both tables are sorted by name for binary search.
+        std::vector<std::size_t> order(images.size());
+        for(std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return images[a].name < images[b].name; });
+        std::vector<std::size_t> remap(images.size());
+        for(std::size_t i = 0; i < order.size(); ++i)
+            remap[order[i]] = i;
+        std::sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b){ return a.name < b.name; });
+        for(std::size_t i = 1; i < sprites.size(); ++i){
+            if(sprites[i - 1].name == sprites[i].name)
+                throw std::invalid_argument("duplicate input " + sprites[i].name);
+        }
+
+        std::string names;
+        auto addName = [&names](const std::string& name){
+            const auto offset = static_cast<uint32_t>(names.size());
+            names += name;
+            names += '\0';
+            return offset;
+        };
+
+        SDL::AssetArchive::FileHeader header{};
+        std::memcpy(header.magic, "SPAK", 4);
+        header.version = SDL::AssetArchive::Version;
+        header.imageCount = static_cast<uint32_t>(images.size());
+        header.spriteCount = static_cast<uint32_t>(sprites.size());
+        header.alignment = options.alignment;
+
+        const auto bytes = static_cast<int>(SDL_BYTESPERPIXEL(options.format));
+        std::vector<SDL::AssetArchive::FileImage> fileImages;
+        for(auto index : order){
+            const auto& image = images[index];
+            const auto pitch = (image.width * bytes + 3) & ~3;
+            fileImages.push_back(SDL::AssetArchive::FileImage{addName(image.name), options.format, image.width, image.height, pitch,
+                image.alpha && options.formatAlpha ? SDL::AssetArchive::ImageAlpha : 0u, 0});
+        }
+        std::vector<SDL::AssetArchive::FileSprite> fileSprites;
+        for(const auto& sprite : sprites)
+            fileSprites.push_back(SDL::AssetArchive::FileSprite{addName(sprite.name), static_cast<uint32_t>(remap[sprite.image]), sprite.rect.x, sprite.rect.y, sprite.rect.w, sprite.rect.h});
+
+        header.namesOffset = static_cast<uint32_t>(sizeof(header) + fileImages.size() * sizeof(fileImages[0]) + fileSprites.size() * sizeof(fileSprites[0]));
+        header.namesSize = static_cast<uint32_t>(names.size());
+        auto offset = Align(header.namesOffset + header.namesSize, options.alignment);
+        for(auto& image : fileImages){
+            image.offset = offset;
+            offset = Align(offset + static_cast<uint64_t>(image.pitch) * image.height, options.alignment);
+        }
+
+        std::ofstream file(options.output, std::ios::binary);
+        if(!file)
+            throw SDL::Error("cannot create " + options.output);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(fileImages.data()), fileImages.size() * sizeof(fileImages[0]));
+        file.write(reinterpret_cast<const char*>(fileSprites.data()), fileSprites.size() * sizeof(fileSprites[0]));
+        file.write(names.data(), names.size());
+
+        const SDL::PixelConvert convert(SDL_PIXELFORMAT_ARGB8888, options.format);
+        std::vector<char> row;
+        for(std::size_t i = 0; i < order.size(); ++i){
+            const auto& image = images[order[i]];
+            const auto& entry = fileImages[i];
+            const auto padding = entry.offset - static_cast<uint64_t>(file.tellp());
+            row.assign(static_cast<std::size_t>(std::max<uint64_t>(padding, entry.pitch)), 0);
+            file.write(row.data(), static_cast<std::streamsize>(padding));
+            for(auto y = 0; y < image.height; ++y){
+                convert.ConvertRow(image.pixels.data() + y * image.width, row.data(), image.width);
+                file.write(row.data(), entry.pitch);
+            }
+        }
+        if(!file.flush())
+            throw SDL::Error("cannot write " + options.output);
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options){
+        for(auto i = 1; i < argc; ++i){
+            const std::string arg = argv[i];
+            if(arg.compare(0, 9, "--format=") == 0){
+                const auto* format = std::find_if(std::begin(formats), std::end(formats), [&](const Format& f){ return arg.compare(9, std::string::npos, f.name) == 0; });
+                if(format == std::end(formats))
+                    return false;
+                options.format = format->format;
+                options.formatAlpha = format->alpha;
+            }else if(arg.compare(0, 8, "--align=") == 0)
+                options.alignment = static_cast<uint32_t>(std::atoi(arg.c_str() + 8));
+            else if(arg.compare(0, 8, "--atlas=") == 0){
+                if(std::sscanf(arg.c_str() + 8, "%dx%d", &options.atlasWidth, &options.atlasHeight) != 2 || options.atlasWidth <= 0 || options.atlasHeight <= 0)
+                    return false;
+            }else if(arg.compare(0, 10, "--padding=") == 0)
+                options.padding = std::atoi(arg.c_str() + 10);
+            else if(arg.compare(0, 2, "--") == 0)
+                return false;
+            else if(options.output.empty())
+                options.output = arg;
+            else
+                options.inputs.push_back(arg);
+        }
+        // The header and tables have to stay 8 byte aligned.
+        return !options.output.empty() && !options.inputs.empty() && options.alignment >= 8 && options.alignment % 8 == 0 && options.padding >= 0;
+    }
+
+}
+
+int main(int argc, char** argv){
+    Options options;
+    if(!ParseOptions(argc, argv, options)){
+        std::cerr << "usage: " << argv[0] << " [--format=argb8888|rgba8888|abgr8888|bgra8888|rgb888|bgr888|rgb565] [--align=BYTES] [--atlas=WIDTHxHEIGHT] [--padding=PIXELS] OUTPUT INPUT..." << std::endl;
+        return 2;
+    }
+
+    try{
+        std::vector<Picture> inputs;
+        for(const auto& path : options.inputs)
+            inputs.push_back(Load(path));
+
+        std::vector<Picture> images;
+        std::vector<Sprite> sprites;
+        if(options.atlasWidth > 0){
+            PackAtlas(options, inputs, images, sprites);
+        }else{
+            for(auto& input : inputs){
+                sprites.push_back(Sprite{input.name, images.size(), SDL::Rect{0, 0, input.width, input.height}});
+                images.push_back(std::move(input));
+            }
+        }
+        Write(options, images, sprites);
+        std::cout << options.output << ": " << images.size() << " images, " << sprites.size() << " sprites" << std::endl;
+    }catch(const std::exception& e){
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}